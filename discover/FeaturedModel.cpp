@@ -15,8 +15,9 @@
 #include <QStandardPaths>
 #include <QtGlobal>
 
+#include <appstream/AppStreamUtils.h>
+#include <resources/AbstractResourcesBackend.h>
 #include <resources/ResourcesModel.h>
-#include <resources/StoredResultsStream.h>
 #include <utils.h>
 
 Q_GLOBAL_STATIC(QString, featuredCache)
@@ -107,31 +108,80 @@ void FeaturedModel::setUris(const QVector<QUrl> &uris)
     if (!m_backend)
         return;
 
-    QSet<ResultsStream *> streams;
-    foreach (const auto &uri, uris) {
-        AbstractResourcesBackend::Filters filter;
-        filter.resourceUrl = uri;
-        streams << m_backend->search(filter);
+    m_positions.clear();
+    for (int i = 0, c = uris.count(); i < c; ++i) {
+        const auto ids = AppStreamUtils::appstreamIds(uris[i]);
+        if (ids.isEmpty())
+            continue;
+
+        // Backends may resolve the entry through any of its ids, so all of them point at the same position
+        for (const QString &id : AppStreamUtils::withDeprecatedAppstreamIds(ids)) {
+            const QString normalized = AppStreamUtils::normalizedAppstreamId(id);
+            if (!normalized.isEmpty() && !m_positions.contains(normalized))
+                m_positions.insert(normalized, i);
+        }
     }
-    if (!streams.isEmpty()) {
-        auto stream = new StoredResultsStream(streams);
-        acquireFetching(true);
-        connect(stream, &StoredResultsStream::finishedResources, this, &FeaturedModel::setResources);
+
+    // Keep showing what we already have, as long as it's still featured
+    auto resources = kFilter<QVector<AbstractResource *>>(m_resources, [this](AbstractResource *res) {
+        return positionOf(res) >= 0;
+    });
+    std::stable_sort(resources.begin(), resources.end(), [this](AbstractResource *a, AbstractResource *b) {
+        return positionOf(a) < positionOf(b);
+    });
+    if (resources != m_resources) {
+        beginResetModel();
+        m_resources = resources;
+        endResetModel();
     }
+
+    if (m_stream) {
+        disconnect(m_stream, nullptr, this, nullptr);
+        m_stream = nullptr;
+        acquireFetching(false);
+    }
+
+    acquireFetching(true);
+    m_stream = m_backend->findResourcesByUrls(uris);
+    connect(m_stream, &ResultsStream::resourcesFound, this, &FeaturedModel::addResources);
+    connect(m_stream, &QObject::destroyed, this, [this] {
+        acquireFetching(false);
+    });
 }
 
-static void filterDupes(QVector<AbstractResource *> &resources)
+int FeaturedModel::positionOf(AbstractResource *resource) const
 {
-    QSet<QString> found;
-    for (auto it = resources.begin(); it != resources.end();) {
-        auto id = (*it)->appstreamId();
-        if (found.contains(id)) {
-            it = resources.erase(it);
-        } else {
-            found.insert(id);
-            ++it;
+    int ret = m_positions.value(AppStreamUtils::normalizedAppstreamId(resource->appstreamId()), -1);
+    if (ret < 0) {
+        const auto alts = resource->alternativeAppstreamIds();
+        for (const auto &alt : alts) {
+            ret = m_positions.value(AppStreamUtils::normalizedAppstreamId(alt), -1);
+            if (ret >= 0)
+                break;
         }
     }
+    return ret;
+}
+
+void FeaturedModel::addResources(const QVector<AbstractResource *> &resources)
+{
+    for (auto res : resources) {
+        const int position = positionOf(res);
+        if (position < 0)
+            continue;
+
+        // There's only one resource per featured entry, the first one the backend offers
+        const auto it = std::lower_bound(m_resources.begin(), m_resources.end(), position, [this](AbstractResource *a, int pos) {
+            return positionOf(a) < pos;
+        });
+        if (it != m_resources.end() && positionOf(*it) == position)
+            continue;
+
+        const int row = it - m_resources.begin();
+        beginInsertRows({}, row, row);
+        m_resources.insert(row, res);
+        endInsertRows();
+    }
 }
 
 void FeaturedModel::acquireFetching(bool f)
@@ -147,21 +197,6 @@ void FeaturedModel::acquireFetching(bool f)
     Q_ASSERT(m_isFetching >= 0);
 }
 
-void FeaturedModel::setResources(const QVector<AbstractResource *> &_resources)
-{
-    auto resources = _resources;
-    filterDupes(resources);
-
-    if (m_resources != resources) {
-        // TODO: sort like in the json files
-        beginResetModel();
-        m_resources = resources;
-        endResetModel();
-    }
-
-    acquireFetching(false);
-}
-
 void FeaturedModel::removeResource(AbstractResource *resource)
 {
     int index = m_resources.indexOf(resource);
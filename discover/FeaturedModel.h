@@ -16,6 +16,7 @@ class StoredTransferJob;
 }
 class AbstractResource;
 class AbstractResourcesBackend;
+class ResultsStream;
 
 class FeaturedModel : public QAbstractListModel
 {
@@ -27,7 +28,7 @@ public:
     {
     }
 
-    void setResources(const QVector<AbstractResource *> &resources);
+    void addResources(const QVector<AbstractResource *> &resources);
     QVariant data(const QModelIndex &index, int role) const override;
     int rowCount(const QModelIndex &parent) const override;
     QHash<int, QByteArray> roleNames() const override;
@@ -45,10 +46,14 @@ private:
     void setUris(const QVector<QUrl> &uris);
     void refresh();
     void removeResource(AbstractResource *resource);
+    int positionOf(AbstractResource *resource) const;
 
     void acquireFetching(bool f);
 
     QVector<AbstractResource *> m_resources;
+    /// position in the featured list of each normalized appstream id
+    QHash<QString, int> m_positions;
+    QPointer<ResultsStream> m_stream;
     int m_isFetching = 0;
     AbstractResourcesBackend *m_backend = nullptr;
 };
@@ -11,10 +11,25 @@
 class PaginateModel::PaginateModelPrivate
 {
 public:
+    enum PendingChange {
+        NoChange,
+        ResizeChange,
+        ShiftChange,
+        ResetChange,
+    };
+
     int m_firstItem = 0;
     int m_pageSize = 0;
     QAbstractItemModel *m_sourceModel = nullptr;
     bool m_hasStaticRowCount = false;
+
+    // What the source's rowsAboutToBe* told us to do, so its counterpart does the same
+    PendingChange m_pendingChange = NoChange;
+    // While shifting the page, rows already removed from its end and where the new ones will go
+    int m_hiddenRows = 0;
+    int m_gapRow = -1;
+
+    bool m_prefetchPending = false;
 };
 
 PaginateModel::PaginateModel(QObject *object)
@@ -38,6 +53,7 @@ void PaginateModel::setFirstItem(int row)
         d->m_firstItem = row;
         endResetModel();
         emit firstItemChanged();
+        schedulePrefetch();
     }
 }
 
@@ -64,6 +80,7 @@ void PaginateModel::setPageSize(int count)
             endRemoveRows();
         }
         emit pageSizeChanged();
+        schedulePrefetch();
     }
 }
 
@@ -108,6 +125,7 @@ void PaginateModel::setSourceModel(QAbstractItemModel *model)
         }
         endResetModel();
         emit sourceModelChanged();
+        schedulePrefetch();
     }
 }
 
@@ -123,14 +141,15 @@ int PaginateModel::rowsByPageSize(int size) const
 
 int PaginateModel::rowCount(const QModelIndex &parent) const
 {
-    return parent.isValid() ? 0 : rowsByPageSize(d->m_pageSize);
+    return parent.isValid() ? 0 : rowsByPageSize(d->m_pageSize) - d->m_hiddenRows;
 }
 
 QModelIndex PaginateModel::mapToSource(const QModelIndex &idx) const
 {
     if (!d->m_sourceModel)
         return QModelIndex();
-    return d->m_sourceModel->index(idx.row() + d->m_firstItem, idx.column());
+    const int gap = d->m_gapRow >= 0 && idx.row() >= d->m_gapRow ? d->m_hiddenRows : 0;
+    return d->m_sourceModel->index(idx.row() + d->m_firstItem + gap, idx.column());
 }
 
 QModelIndex PaginateModel::mapFromSource(const QModelIndex &idx) const
@@ -201,6 +220,30 @@ void PaginateModel::setStaticRowCount(bool src)
     Q_EMIT staticRowCountChanged();
 }
 
+void PaginateModel::schedulePrefetch()
+{
+    if (d->m_prefetchPending || !d->m_sourceModel) {
+        return;
+    }
+
+    // Don't ask the source for more while it's still telling us about its changes
+    d->m_prefetchPending = true;
+    QMetaObject::invokeMethod(this, &PaginateModel::prefetch, Qt::QueuedConnection);
+}
+
+void PaginateModel::prefetch()
+{
+    d->m_prefetchPending = false;
+    if (!d->m_sourceModel || d->m_pageSize <= 0) {
+        return;
+    }
+
+    const int nextPageEnd = d->m_firstItem + 2 * d->m_pageSize;
+    if (d->m_sourceModel->rowCount() < nextPageEnd && d->m_sourceModel->canFetchMore({})) {
+        d->m_sourceModel->fetchMore({});
+    }
+}
+
 //////////////////////////////
 
 void PaginateModel::_k_sourceColumnsAboutToBeInserted(const QModelIndex &parent, int start, int end)
@@ -290,6 +333,7 @@ void PaginateModel::_k_sourceModelAboutToBeReset()
 void PaginateModel::_k_sourceModelReset()
 {
     endResetModel();
+    schedulePrefetch();
 }
 
 bool PaginateModel::isIntervalValid(const QModelIndex &parent, int start, int /*end*/) const
@@ -304,30 +348,57 @@ bool PaginateModel::canSizeChange() const
 
 void PaginateModel::_k_sourceRowsAboutToBeInserted(const QModelIndex &parent, int start, int end)
 {
+    d->m_pendingChange = PaginateModelPrivate::NoChange;
     if (!isIntervalValid(parent, start, end)) {
         return;
     }
 
+    const int newStart = qMax(start - d->m_firstItem, 0);
+    const int count = end - start + 1;
     if (canSizeChange()) {
-        const int newStart = qMax(start - d->m_firstItem, 0);
         const int insertedCount = qMin(end - start, pageSize() - newStart - 1);
         beginInsertRows(QModelIndex(), newStart, newStart + insertedCount);
+        d->m_pendingChange = PaginateModelPrivate::ResizeChange;
+    } else if (newStart >= rowCount()) {
+        // Right after the page, nothing to show
+    } else if (newStart + count <= rowCount()) {
+        // The page is full: the rows pushed out of its end leave now, the new ones come in once the source has them
+        const int rows = rowCount();
+        beginRemoveRows(QModelIndex(), rows - count, rows - 1);
+        d->m_hiddenRows = count;
+        endRemoveRows();
+        d->m_pendingChange = PaginateModelPrivate::ShiftChange;
     } else {
         beginResetModel();
+        d->m_pendingChange = PaginateModelPrivate::ResetChange;
     }
 }
 
 void PaginateModel::_k_sourceRowsInserted(const QModelIndex &parent, int start, int end)
 {
-    if (!isIntervalValid(parent, start, end)) {
-        return;
-    }
-
-    if (canSizeChange()) {
+    Q_UNUSED(parent)
+    Q_UNUSED(end)
+    switch (d->m_pendingChange) {
+    case PaginateModelPrivate::ResizeChange:
         endInsertRows();
-    } else {
+        break;
+    case PaginateModelPrivate::ShiftChange: {
+        const int row = qMax(start - d->m_firstItem, 0);
+        d->m_gapRow = row;
+        beginInsertRows(QModelIndex(), row, row + d->m_hiddenRows - 1);
+        d->m_gapRow = -1;
+        d->m_hiddenRows = 0;
+        endInsertRows();
+        break;
+    }
+    case PaginateModelPrivate::ResetChange:
         endResetModel();
+        break;
+    case PaginateModelPrivate::NoChange:
+        break;
     }
+    d->m_pendingChange = PaginateModelPrivate::NoChange;
+    schedulePrefetch();
 }
 
 void PaginateModel::_k_sourceRowsAboutToBeMoved(const QModelIndex &sourceParent, int sourceStart, int sourceEnd, const QModelIndex &destParent, int dest)
@@ -353,6 +424,7 @@ void PaginateModel::_k_sourceRowsMoved(const QModelIndex &sourceParent, int sour
 
 void PaginateModel::_k_sourceRowsAboutToBeRemoved(const QModelIndex &parent, int start, int end)
 {
+    d->m_pendingChange = PaginateModelPrivate::NoChange;
     if (!isIntervalValid(parent, start, end)) {
         return;
     }
@@ -361,22 +433,25 @@ void PaginateModel::_k_sourceRowsAboutToBeRemoved(const QModelIndex &parent, int
         const int removedCount = end - start;
         const int newStart = qMax(start - d->m_firstItem, 0);
         beginRemoveRows(QModelIndex(), newStart, newStart + removedCount);
+        d->m_pendingChange = PaginateModelPrivate::ResizeChange;
     } else {
         beginResetModel();
+        d->m_pendingChange = PaginateModelPrivate::ResetChange;
     }
 }
 
 void PaginateModel::_k_sourceRowsRemoved(const QModelIndex &parent, int start, int end)
 {
-    if (!isIntervalValid(parent, start, end)) {
-        return;
-    }
-
-    if (canSizeChange()) {
+    Q_UNUSED(parent)
+    Q_UNUSED(start)
+    Q_UNUSED(end)
+    if (d->m_pendingChange == PaginateModelPrivate::ResizeChange) {
         endRemoveRows();
-    } else {
-        beginResetModel();
+    } else if (d->m_pendingChange == PaginateModelPrivate::ResetChange) {
+        endResetModel();
     }
+    d->m_pendingChange = PaginateModelPrivate::NoChange;
+    schedulePrefetch();
 }
 
 int PaginateModel::lastItem() const
@@ -8,6 +8,7 @@
 #define PAGINATEMODEL_H
 
 #include <QAbstractListModel>
+#include <QStringList>
 
 /**
  * @class PaginateModel
@@ -114,6 +115,8 @@ private:
     bool canSizeChange() const;
     bool isIntervalValid(const QModelIndex &parent, int start, int end) const;
     int rowsByPageSize(int size) const;
+    void schedulePrefetch();
+    void prefetch();
 
     class PaginateModelPrivate;
     QScopedPointer<PaginateModelPrivate> d;
@@ -81,20 +81,24 @@ private Q_SLOTS:
         pm.setPageSize(5);
         QCOMPARE(pm.pageCount(), 3);
         QSignalSpy spy(&pm, &QAbstractItemModel::rowsAboutToBeInserted);
+        QSignalSpy spyReset(&pm, &QAbstractItemModel::modelAboutToBeReset);
         insertRow(m_testModel, 3, QStringLiteral("mwahahaha"));
         insertRow(m_testModel, 3, QStringLiteral("mwahahaha"));
-        QCOMPARE(spy.count(), 0);
+        QCOMPARE(spy.count(), 2);
+        QCOMPARE(spyReset.count(), 0);
+        QCOMPARE(pm.rowCount(), 5);
+        QCOMPARE(pm.index(3).data().toString(), QStringLiteral("mwahahaha"));
         appendRow(m_testModel, QStringLiteral("mwahahaha"));
 
         pm.lastPage();
         for (int i = 0; i < 7; ++i)
             appendRow(m_testModel, QStringLiteral("mwahahaha%1").arg(i));
-        QCOMPARE(spy.count(), 4);
+        QCOMPARE(spy.count(), 6);
         pm.firstPage();
 
         for (int i = 0; i < 7; ++i)
             appendRow(m_testModel, QStringLiteral("faraway%1").arg(i));
-        QCOMPARE(spy.count(), 4);
+        QCOMPARE(spy.count(), 6);
     }
 
     void testItemAddBeginning()
@@ -132,6 +136,95 @@ private Q_SLOTS:
         QCOMPARE(spy.count(), 1);
     }
 
+    void testInsertBeforePage()
+    {
+        QStringListModel model;
+        for (int i = 0; i < 20; ++i) {
+            appendRow(&model, QStringLiteral("row%1").arg(i));
+        }
+
+        PaginateModel pm;
+        new QAbstractItemModelTester(&pm, &pm);
+        pm.setSourceModel(&model);
+        pm.setPageSize(5);
+        pm.setFirstItem(5);
+
+        QSignalSpy spyReset(&pm, &QAbstractItemModel::modelAboutToBeReset);
+        QSignalSpy spyInserted(&pm, &QAbstractItemModel::rowsInserted);
+        QSignalSpy spyRemoved(&pm, &QAbstractItemModel::rowsRemoved);
+        insertRow(&model, 0, QStringLiteral("first"));
+        insertRow(&model, 1, QStringLiteral("second"));
+        QCOMPARE(spyReset.count(), 0);
+        QCOMPARE(spyInserted.count(), 2);
+        QCOMPARE(spyRemoved.count(), 2);
+        QCOMPARE(pm.rowCount(), 5);
+        for (int i = 0; i < pm.rowCount(); ++i) {
+            QCOMPARE(pm.index(i).data(), model.index(i + 5).data());
+        }
+
+        // Inserting more than a page at once is better off as a reset
+        model.insertRows(0, 6);
+        QCOMPARE(spyReset.count(), 1);
+    }
+
+    void testPrefetch()
+    {
+        class PagedModel : public QStringListModel
+        {
+        public:
+            bool canFetchMore(const QModelIndex &parent) const override
+            {
+                return !parent.isValid() && rowCount() < 30;
+            }
+            void fetchMore(const QModelIndex &parent) override
+            {
+                Q_UNUSED(parent)
+                for (int i = 0; i < 10; ++i) {
+                    appendRow(this, QStringLiteral("fetched%1").arg(rowCount()));
+                }
+            }
+        };
+        PagedModel model;
+        model.fetchMore({});
+
+        PaginateModel pm;
+        new QAbstractItemModelTester(&pm, &pm);
+        pm.setSourceModel(&model);
+        pm.setPageSize(5);
+        QTRY_COMPARE(model.rowCount(), 10);
+
+        // The next page is there already, so no more is fetched until we get close to the end
+        pm.setFirstItem(5);
+        QTRY_COMPARE(model.rowCount(), 20);
+        pm.setFirstItem(10);
+        QTest::qWait(0);
+        QCOMPARE(model.rowCount(), 20);
+        pm.setFirstItem(15);
+        QTRY_COMPARE(model.rowCount(), 30);
+    }
+
+    void benchmarkInsertBeforePage()
+    {
+        QStringListModel model;
+        QStringList rows;
+        for (int i = 0; i < 10000; ++i) {
+            rows += QStringLiteral("row%1").arg(i);
+        }
+        model.setStringList(rows);
+
+        PaginateModel pm;
+        pm.setSourceModel(&model);
+        pm.setPageSize(50);
+        pm.setFirstItem(5000);
+
+        // Like a stream of search results arriving while the user looks at a page
+        QSignalSpy spyReset(&pm, &QAbstractItemModel::modelAboutToBeReset);
+        QBENCHMARK {
+            insertRow(&model, 0, QStringLiteral("new"));
+        }
+        QCOMPARE(spyReset.count(), 0);
+    }
+
     void testMove()
     {
         PaginateModel pm;
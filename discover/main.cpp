@@ -20,6 +20,7 @@
 #include <QTextStream>
 #include <QWindow>
 #include <kstartupinfo.h>
+#include <resources/ResourcesModel.h>
 
 #include <QX11Info>
 
@@ -47,6 +48,7 @@ QCommandLineParser *createParser()
     parser->addOption(QCommandLineOption(QStringLiteral("search"), i18n("Search string."), QStringLiteral("text")));
     parser->addOption(QCommandLineOption(QStringLiteral("feedback"), i18n("Lists the available options for user feedback")));
     parser->addOption(QCommandLineOption(QStringLiteral("test"), QStringLiteral("Test file"), QStringLiteral("file.qml")));
+    parser->addOption(QCommandLineOption(QStringLiteral("memory-report"), QStringLiteral("Prints the memory held by the resources of each backend once loaded")));
     parser->addPositionalArgument(QStringLiteral("urls"), i18n("Supports appstream: url scheme"));
     // clang-format on
     DiscoverBackendsFactory::setupCommandLine(parser);
@@ -131,6 +133,14 @@ int main(int argc, char **argv)
             QStandardPaths::setTestModeEnabled(true);
         }
 
+        if (parser->isSet(QStringLiteral("memory-report"))) {
+            QObject::connect(ResourcesModel::global(), &ResourcesModel::allInitialized, &app, [] {
+                QTextStream(stdout) << ResourcesModel::global()->memoryReport();
+                QCoreApplication::quit();
+            });
+            return app.exec();
+        }
+
         KDBusService *service = new KDBusService(KDBusService::Unique, &app);
 
         {
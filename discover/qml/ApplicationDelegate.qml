@@ -21,6 +21,11 @@ Kirigami.AbstractCard
     readonly property bool appIsFromNonDefaultBackend: ResourcesModel.currentApplicationBackend !== application.backend && application.backend.hasApplications
     showClickFeedback: true
 
+    onApplicationChanged: {
+        if (showRating && application && application.backend.reviewsBackend)
+            application.backend.reviewsBackend.prefetchReviews(application)
+    }
+
     function trigger() {
         if (delegateRecycler.ListView.view)
             delegateRecycler.ListView.view.currentIndex = index
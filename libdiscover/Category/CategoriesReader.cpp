@@ -7,18 +7,33 @@
 #include "CategoriesReader.h"
 #include "Category.h"
 #include "libdiscover_debug.h"
+#include <KLocalizedString>
 #include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
 #include <QDomNode>
 #include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
 #include <QStandardPaths>
 
 #include <DiscoverBackendsFactory.h>
 #include <resources/AbstractResourcesBackend.h>
+#include <utils.h>
+
+static const quint32 s_cacheMagic = 0x44434154; // "DCAT"
+static const quint32 s_cacheVersion = 1;
+
+QString CategoriesReader::categoriesPath(AbstractResourcesBackend *backend)
+{
+    return QStandardPaths::locate(QStandardPaths::GenericDataLocation, QLatin1String("libdiscover/categories/") + backend->name() + QLatin1String("-categories.xml"));
+}
 
 QVector<Category *> CategoriesReader::loadCategoriesFile(AbstractResourcesBackend *backend)
 {
-    QString path = QStandardPaths::locate(QStandardPaths::GenericDataLocation,
-                                          QLatin1String("libdiscover/categories/") + backend->name() + QLatin1String("-categories.xml"));
+    const QString path = categoriesPath(backend);
     if (path.isEmpty()) {
         auto cat = backend->category();
         if (cat.isEmpty())
@@ -60,3 +75,85 @@ QVector<Category *> CategoriesReader::loadCategoriesPath(const QString &path)
     Category::sortCategories(ret);
     return ret;
 }
+
+static QString cacheFilePath(const QStringList &paths)
+{
+    const QByteArray id = QCryptographicHash::hash(paths.join(QLatin1Char(':')).toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/categories/") + QString::fromLatin1(id) + QLatin1String(".cache");
+}
+
+static QVector<Category *> readCache(const QString &cachePath, const QStringList &paths, const QVector<qint64> &mtimes)
+{
+    QFile file(cachePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    quint32 magic = 0, version = 0;
+    stream >> magic >> version;
+    if (magic != s_cacheMagic || version != s_cacheVersion)
+        return {};
+
+    QStringList cachedPaths, cachedLanguages;
+    QVector<qint64> cachedMtimes;
+    quint32 count = 0;
+    stream >> cachedPaths >> cachedMtimes >> cachedLanguages >> count;
+    if (stream.status() != QDataStream::Ok || cachedPaths != paths || cachedMtimes != mtimes || cachedLanguages != KLocalizedString::languages())
+        return {};
+
+    QVector<Category *> ret;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+        ret << Category::deserialize(stream, qApp);
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(LIBDISCOVER_LOG) << "discarding corrupt categories cache" << cachePath;
+        qDeleteAll(ret);
+        return {};
+    }
+    return ret;
+}
+
+static void writeCache(const QString &cachePath, const QStringList &paths, const QVector<qint64> &mtimes, const QVector<Category *> &categories)
+{
+    QDir().mkpath(QFileInfo(cachePath).absolutePath());
+    QSaveFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(LIBDISCOVER_LOG) << "couldn't write the categories cache" << cachePath << file.errorString();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << s_cacheMagic << s_cacheVersion << paths << mtimes << KLocalizedString::languages() << quint32(categories.size());
+    for (const Category *cat : categories)
+        cat->serialize(stream);
+    file.commit();
+}
+
+QVector<Category *> CategoriesReader::loadCategoriesPaths(const QStringList &paths)
+{
+    if (paths.isEmpty())
+        return {};
+
+    const QString cachePath = cacheFilePath(paths);
+    const auto mtimes = kTransform<QVector<qint64>>(paths, [](const QString &path) {
+        return QFileInfo(path).lastModified().toMSecsSinceEpoch();
+    });
+
+    QVector<Category *> ret = readCache(cachePath, paths, mtimes);
+    if (!ret.isEmpty())
+        return ret;
+
+    for (const QString &path : paths) {
+        const QVector<Category *> cats = loadCategoriesPath(path);
+        if (ret.isEmpty()) {
+            ret = cats;
+        } else {
+            for (Category *c : cats)
+                Category::addSubcategory(ret, c);
+        }
+    }
+    writeCache(cachePath, paths, mtimes, ret);
+    return ret;
+}
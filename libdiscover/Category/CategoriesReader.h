@@ -8,6 +8,7 @@
 #define CATEGORIESREADER_H
 
 #include "discovercommon_export.h"
+#include <QStringList>
 #include <QVector>
 
 class Category;
@@ -17,6 +18,17 @@ class DISCOVERCOMMON_EXPORT CategoriesReader
 public:
     QVector<Category *> loadCategoriesPath(const QString &path);
     QVector<Category *> loadCategoriesFile(AbstractResourcesBackend *backend);
+
+    /**
+     * Loads the categories in @p paths and merges them into one tree.
+     *
+     * The merged tree is kept in a binary cache keyed by the files, their modification
+     * time and the languages in use, so the XML only gets parsed when one of them changes.
+     */
+    QVector<Category *> loadCategoriesPaths(const QStringList &paths);
+
+    /// @returns the categories file provided for @p backend, empty if the backend builds its own categories
+    static QString categoriesPath(AbstractResourcesBackend *backend);
 };
 
 #endif // CATEGORIESREADER_H
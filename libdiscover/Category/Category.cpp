@@ -5,7 +5,9 @@
  */
 
 #include "Category.h"
+#include "CategoryMatcher.h"
 
+#include <QDataStream>
 #include <QDomNode>
 
 #include "libdiscover_debug.h"
@@ -78,6 +80,55 @@ void Category::parseData(const QString &path, const QDomNode &data)
     }
 }
 
+static void writeFilters(QDataStream &stream, const QVector<QPair<FilterType, QString>> &filters)
+{
+    stream << quint32(filters.size());
+    for (const auto &filter : filters)
+        stream << qint32(filter.first) << filter.second;
+}
+
+static QVector<QPair<FilterType, QString>> readFilters(QDataStream &stream)
+{
+    quint32 count = 0;
+    stream >> count;
+    QVector<QPair<FilterType, QString>> ret;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        qint32 type = InvalidFilter;
+        QString value;
+        stream >> type >> value;
+        ret.append({FilterType(type), value});
+    }
+    return ret;
+}
+
+void Category::serialize(QDataStream &stream) const
+{
+    // Merged subcategories can have a parent other than the one they were parsed in, keep the decoration they resolved to
+    stream << m_name << m_iconString << decoration() << m_isAddons << m_plugins;
+    writeFilters(stream, m_andFilters);
+    writeFilters(stream, m_orFilters);
+    writeFilters(stream, m_notFilters);
+    stream << quint32(m_subCategories.size());
+    for (const Category *subCat : m_subCategories)
+        subCat->serialize(stream);
+}
+
+Category *Category::deserialize(QDataStream &stream, QObject *parent)
+{
+    auto cat = new Category({}, parent);
+    stream >> cat->m_name >> cat->m_iconString >> cat->m_decoration >> cat->m_isAddons >> cat->m_plugins;
+    cat->setObjectName(cat->m_name);
+    cat->m_andFilters = readFilters(stream);
+    cat->m_orFilters = readFilters(stream);
+    cat->m_notFilters = readFilters(stream);
+
+    quint32 count = 0;
+    stream >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+        cat->m_subCategories << deserialize(stream, cat);
+    return cat;
+}
+
 QVector<QPair<FilterType, QString>> Category::parseIncludes(const QDomNode &data)
 {
     QDomNode node = data.firstChild();
@@ -135,6 +186,7 @@ QVector<QPair<FilterType, QString>> Category::andFilters() const
 void Category::setAndFilter(QVector<QPair<FilterType, QString>> filters)
 {
     m_andFilters = filters;
+    m_matcher.reset();
 }
 
 QVector<QPair<FilterType, QString>> Category::orFilters() const
@@ -196,6 +248,7 @@ void Category::addSubcategory(QVector<Category *> &list, Category *newcat)
         } else {
             c->m_orFilters += newcat->orFilters();
             c->m_notFilters += newcat->notFilters();
+            c->m_matcher.reset();
             c->m_plugins.unite(newcat->m_plugins);
             Q_FOREACH (Category *nc, newcat->subCategories()) {
                 addSubcategory(c->m_subCategories, nc);
@@ -273,6 +326,13 @@ bool Category::matchesCategoryName(const QString &name) const
     return false;
 }
 
+const CategoryMatcher *Category::matcher() const
+{
+    if (!m_matcher)
+        m_matcher.reset(new CategoryMatcher(this));
+    return m_matcher.data();
+}
+
 bool Category::contains(Category *cat) const
 {
     const bool ret = cat == this || (cat && contains(qobject_cast<Category *>(cat->parent())));
@@ -9,13 +9,16 @@
 
 #include <QObject>
 #include <QPair>
+#include <QScopedPointer>
 #include <QSet>
 #include <QUrl>
 #include <QVector>
 
 #include "discovercommon_export.h"
 
+class QDataStream;
 class QDomNode;
+class CategoryMatcher;
 
 enum FilterType {
     InvalidFilter,
@@ -67,6 +70,9 @@ public:
      */
     void addSubcategory(Category *cat);
     void parseData(const QString &path, const QDomNode &data);
+    /// Writes the category and its subcategories to @p stream, to be read back with deserialize()
+    void serialize(QDataStream &stream) const;
+    static Category *deserialize(QDataStream &stream, QObject *parent);
     bool blacklistPlugins(const QSet<QString> &pluginName);
     bool isAddons() const
     {
@@ -75,6 +81,9 @@ public:
     QUrl decoration() const;
     bool matchesCategoryName(const QString &name) const;
 
+    /// @returns the filters of the category, compiled the first time they are needed
+    const CategoryMatcher *matcher() const;
+
     Q_SCRIPTABLE bool contains(Category *cat) const;
     Q_SCRIPTABLE bool contains(const QVariantList &cats) const;
 
@@ -97,6 +106,7 @@ private:
     QVector<QPair<FilterType, QString>> parseIncludes(const QDomNode &data);
     QSet<QString> m_plugins;
     bool m_isAddons = false;
+    mutable QScopedPointer<CategoryMatcher> m_matcher;
 };
 
 #endif
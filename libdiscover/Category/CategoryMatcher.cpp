@@ -0,0 +1,121 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "CategoryMatcher.h"
+#include <QHash>
+#include <QMutex>
+#include <resources/AbstractResource.h>
+
+struct CategoryAtoms {
+    QMutex mutex;
+    QHash<QString, int> ids;
+};
+Q_GLOBAL_STATIC(CategoryAtoms, s_atoms)
+
+int CategoryMatcher::internCategory(const QString &name)
+{
+    QMutexLocker locker(&s_atoms->mutex);
+    auto it = s_atoms->ids.constFind(name);
+    if (it == s_atoms->ids.constEnd())
+        it = s_atoms->ids.insert(name, s_atoms->ids.count());
+    return *it;
+}
+
+/// Relative cost of evaluating each kind of filter
+static int filterCost(FilterType type)
+{
+    switch (type) {
+    case CategoryFilter:
+        return 0;
+    case PkgNameFilter:
+    case PkgSectionFilter:
+        return 1;
+    case PkgWildcardFilter:
+    case AppstreamIdWildcardFilter:
+        return 2;
+    case InvalidFilter:
+        break;
+    }
+    return 3;
+}
+
+CategoryMatcher::CategoryMatcher(const Category *category)
+    : m_orFilters(compile(category->orFilters()))
+    , m_andFilters(compile(category->andFilters()))
+    , m_notFilters(compile(category->notFilters()))
+{
+}
+
+QVector<CategoryMatcher::Filter> CategoryMatcher::compile(const QVector<QPair<FilterType, QString>> &filters)
+{
+    QVector<Filter> ret;
+    ret.reserve(filters.size());
+    for (const auto &filter : filters) {
+        Filter compiled{filter.first, -1, filter.second, {}};
+        switch (filter.first) {
+        case CategoryFilter:
+            compiled.atom = internCategory(filter.second);
+            break;
+        case PkgWildcardFilter:
+        case AppstreamIdWildcardFilter:
+            compiled.value.remove(QLatin1Char('*'));
+            compiled.wildcard.setPattern(compiled.value);
+            break;
+        default:
+            break;
+        }
+        ret += compiled;
+    }
+
+    // The order doesn't change the result, so start with what's cheapest
+    std::stable_sort(ret.begin(), ret.end(), [](const Filter &a, const Filter &b) {
+        return filterCost(a.type) < filterCost(b.type);
+    });
+    return ret;
+}
+
+bool CategoryMatcher::matches(AbstractResource *res, const Filter &filter)
+{
+    switch (filter.type) {
+    case CategoryFilter: {
+        const auto &ids = res->categoryIds();
+        return std::binary_search(ids.constBegin(), ids.constEnd(), filter.atom);
+    }
+    case PkgSectionFilter:
+        return res->section() == filter.value;
+    case PkgWildcardFilter:
+        return filter.wildcard.indexIn(res->packageName()) >= 0;
+    case AppstreamIdWildcardFilter:
+        return filter.wildcard.indexIn(res->appstreamId()) >= 0;
+    case PkgNameFilter: // Only useful in the not filters
+        return res->packageName() == filter.value;
+    case InvalidFilter:
+        break;
+    }
+    return true;
+}
+
+bool CategoryMatcher::matches(AbstractResource *res) const
+{
+    if (!m_orFilters.isEmpty()) {
+        const bool orValue = std::any_of(m_orFilters.constBegin(), m_orFilters.constEnd(), [res](const Filter &filter) {
+            return matches(res, filter);
+        });
+        if (!orValue)
+            return false;
+    }
+
+    for (const auto &filter : m_andFilters) {
+        if (!matches(res, filter))
+            return false;
+    }
+
+    for (const auto &filter : m_notFilters) {
+        if (matches(res, filter))
+            return false;
+    }
+    return true;
+}
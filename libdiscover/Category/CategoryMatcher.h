@@ -0,0 +1,52 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#ifndef CATEGORYMATCHER_H
+#define CATEGORYMATCHER_H
+
+#include "Category.h"
+#include "discovercommon_export.h"
+#include <QStringMatcher>
+#include <QVector>
+
+class AbstractResource;
+
+/**
+ * \class CategoryMatcher  CategoryMatcher.h "CategoryMatcher.h"
+ *
+ * \brief The filters of a Category, prepared to be checked against many resources.
+ *
+ * Category names are interned into integers so that they can be compared with
+ * AbstractResource::categoryIds(), wildcards are stripped and precompiled once and
+ * the filters are sorted so that the cheapest ones get evaluated first.
+ */
+class DISCOVERCOMMON_EXPORT CategoryMatcher
+{
+public:
+    explicit CategoryMatcher(const Category *category);
+
+    bool matches(AbstractResource *res) const;
+
+    /// @returns a unique id for the category @p name
+    static int internCategory(const QString &name);
+
+private:
+    struct Filter {
+        FilterType type;
+        int atom;
+        QString value;
+        QStringMatcher wildcard;
+    };
+
+    static QVector<Filter> compile(const QVector<QPair<FilterType, QString>> &filters);
+    static bool matches(AbstractResource *res, const Filter &filter);
+
+    QVector<Filter> m_orFilters;
+    QVector<Filter> m_andFilters;
+    QVector<Filter> m_notFilters;
+};
+
+#endif // CATEGORYMATCHER_H
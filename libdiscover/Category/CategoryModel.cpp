@@ -35,12 +35,23 @@ void CategoryModel::populateCategories()
 {
     const auto backends = ResourcesModel::global()->backends();
 
-    QVector<Category *> ret;
-    CategoriesReader cr;
-    Q_FOREACH (const auto backend, backends) {
+    // Backends shipping a categories file get merged in one go, from the cache when possible
+    QStringList paths;
+    QVector<AbstractResourcesBackend *> otherBackends;
+    for (const auto backend : backends) {
         if (!backend->isValid())
             continue;
 
+        const QString path = CategoriesReader::categoriesPath(backend);
+        if (path.isEmpty())
+            otherBackends += backend;
+        else
+            paths += path;
+    }
+
+    CategoriesReader cr;
+    QVector<Category *> ret = cr.loadCategoriesPaths(paths);
+    for (const auto backend : qAsConst(otherBackends)) {
         const QVector<Category *> cats = cr.loadCategoriesFile(backend);
 
         if (ret.isEmpty()) {
@@ -31,6 +31,18 @@ bool DiscoverBackendsFactory::hasRequestedBackends()
     return !s_requestedBackends->isEmpty();
 }
 
+static bool s_updatesOnly = false;
+
+void DiscoverBackendsFactory::setUpdatesOnly(bool updatesOnly)
+{
+    s_updatesOnly = updatesOnly;
+}
+
+bool DiscoverBackendsFactory::isUpdatesOnly()
+{
+    return s_updatesOnly;
+}
+
 DiscoverBackendsFactory::DiscoverBackendsFactory()
 {
 }
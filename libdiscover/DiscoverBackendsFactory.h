@@ -29,6 +29,15 @@ public:
     static void setRequestedBackends(const QStringList &backends);
     static bool hasRequestedBackends();
 
+    /**
+     * Backends will only be used to check for and apply updates, they can skip loading
+     * whatever is only needed for browsing (e.g. the AppStream catalog or the ratings).
+     *
+     * Needs to be set before the backends are loaded.
+     */
+    static void setUpdatesOnly(bool updatesOnly);
+    static bool isUpdatesOnly();
+
 private:
     QVector<AbstractResourcesBackend *> backendForFile(const QString &path, const QString &name) const;
 };
@@ -16,6 +16,11 @@ bool AbstractReviewsBackend::isReviewable() const
     return true;
 }
 
+void AbstractReviewsBackend::prefetchReviews(AbstractResource *app)
+{
+    Q_UNUSED(app)
+}
+
 QString AbstractReviewsBackend::errorMessage() const
 {
     return QString();
@@ -32,6 +32,13 @@ public:
     virtual bool isFetching() const = 0;
     virtual bool isReviewable() const;
 
+    /**
+     * Hints that the reviews of @p app are likely to be requested soon, e.g. because it's being listed.
+     *
+     * Backends can use it to have the first page of reviews ready by then, it does nothing by default.
+     */
+    Q_INVOKABLE virtual void prefetchReviews(AbstractResource *app);
+
 public Q_SLOTS:
     virtual void login() = 0;
     virtual void registerAndLogin() = 0;
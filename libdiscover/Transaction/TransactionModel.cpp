@@ -10,6 +10,7 @@
 #include <KLocalizedString>
 #include <QDebug>
 #include <QMetaProperty>
+#include <QTimer>
 
 // Own includes
 #include "libdiscover_debug.h"
@@ -24,7 +25,12 @@ TransactionModel *TransactionModel::global()
 
 TransactionModel::TransactionModel(QObject *parent)
     : QAbstractListModel(parent)
+    , m_progressTimer(new QTimer(this))
 {
+    m_progressTimer->setInterval(16);
+    m_progressTimer->setSingleShot(true);
+    connect(m_progressTimer, &QTimer::timeout, this, &TransactionModel::flushProgress);
+
     connect(this, &QAbstractItemModel::rowsInserted, this, &TransactionModel::countChanged);
     connect(this, &QAbstractItemModel::rowsRemoved, this, &TransactionModel::countChanged);
     connect(this, &TransactionModel::countChanged, this, &TransactionModel::progressChanged);
@@ -105,22 +111,12 @@ QVariant TransactionModel::data(const QModelIndex &index, int role) const
 
 Transaction *TransactionModel::transactionFromResource(AbstractResource *resource) const
 {
-    Transaction *ret = nullptr;
-
-    Q_FOREACH (Transaction *trans, m_transactions) {
-        if (trans->resource() == resource) {
-            ret = trans;
-            break;
-        }
-    }
-
-    return ret;
+    return m_transactionByResource.value(resource);
 }
 
 QModelIndex TransactionModel::indexOf(Transaction *trans) const
 {
-    int row = m_transactions.indexOf(trans);
-    QModelIndex ret = index(row);
+    QModelIndex ret = index(m_rows.value(trans, -1));
     Q_ASSERT(!trans || ret.isValid());
     return ret;
 }
@@ -137,26 +133,34 @@ void TransactionModel::addTransaction(Transaction *trans)
     if (!trans)
         return;
 
-    if (m_transactions.contains(trans))
+    if (m_rows.contains(trans))
         return;
 
     if (m_transactions.isEmpty())
         emit startingFirstTransaction();
 
     int before = m_transactions.size();
-    beginInsertRows(QModelIndex(), before, before + 1);
+    beginInsertRows(QModelIndex(), before, before);
     m_transactions.append(trans);
+    m_rows.insert(trans, before);
+    if (!m_transactionByResource.contains(trans->resource()))
+        m_transactionByResource.insert(trans->resource(), trans);
+    updateProgress(trans);
     endInsertRows();
 
-    connect(trans, &Transaction::statusChanged, this, [this]() {
+    connect(trans, &Transaction::statusChanged, this, [this, trans]() {
         transactionChanged(StatusTextRole);
+        updateProgress(trans);
     });
     connect(trans, &Transaction::cancellableChanged, this, [this]() {
         transactionChanged(CancellableRole);
     });
-    connect(trans, &Transaction::progressChanged, this, [this]() {
-        transactionChanged(ProgressRole);
-        Q_EMIT progressChanged();
+    connect(trans, &Transaction::visibleChanged, this, [this, trans]() {
+        updateProgress(trans);
+    });
+    connect(trans, &Transaction::progressChanged, this, [this, trans]() {
+        m_pendingProgress.insert(trans);
+        updateProgress(trans);
     });
 
     emit transactionAdded(trans);
@@ -166,7 +170,7 @@ void TransactionModel::removeTransaction(Transaction *trans)
 {
     Q_ASSERT(trans);
     trans->deleteLater();
-    int r = m_transactions.indexOf(trans);
+    int r = m_rows.value(trans, -1);
     if (r < 0) {
         qCWarning(LIBDISCOVER_LOG) << "transaction not part of the model" << trans;
         return;
@@ -176,6 +180,29 @@ void TransactionModel::removeTransaction(Transaction *trans)
 
     beginRemoveRows(QModelIndex(), r, r);
     m_transactions.removeAt(r);
+    m_rows.remove(trans);
+    for (int i = r, c = m_transactions.count(); i < c; ++i)
+        m_rows[m_transactions[i]] = i;
+
+    auto it = m_transactionByResource.find(trans->resource());
+    if (it != m_transactionByResource.end() && *it == trans) {
+        m_transactionByResource.erase(it);
+        // Another transaction might be taking care of the same resource
+        for (Transaction *t : qAsConst(m_transactions)) {
+            if (t->resource() == trans->resource()) {
+                m_transactionByResource.insert(t->resource(), t);
+                break;
+            }
+        }
+    }
+
+    m_pendingProgress.remove(trans);
+    const int contribution = m_progressContributions.value(trans, -1);
+    m_progressContributions.remove(trans);
+    if (contribution >= 0) {
+        m_progressSum -= contribution;
+        --m_progressCount;
+    }
     endRemoveRows();
 
     emit transactionRemoved(trans);
@@ -192,13 +219,50 @@ void TransactionModel::transactionChanged(int role)
 
 int TransactionModel::progress() const
 {
-    int sum = 0;
-    int count = 0;
-    foreach (Transaction *t, m_transactions) {
-        if (t->isActive() && t->isVisible()) {
-            sum += t->progress();
-            ++count;
+    return m_progressCount == 0 ? 0 : m_progressSum / m_progressCount;
+}
+
+void TransactionModel::updateProgress(Transaction *trans)
+{
+    const int contribution = trans->isActive() && trans->isVisible() ? trans->progress() : -1;
+    auto it = m_progressContributions.find(trans);
+    if (it == m_progressContributions.end())
+        it = m_progressContributions.insert(trans, -1);
+
+    if (*it >= 0) {
+        m_progressSum -= *it;
+        --m_progressCount;
+    }
+    if (contribution >= 0) {
+        m_progressSum += contribution;
+        ++m_progressCount;
+    }
+    *it = contribution;
+
+    if (!m_progressTimer->isActive())
+        m_progressTimer->start();
+}
+
+void TransactionModel::flushProgress()
+{
+    // Notify consecutive rows with a single dataChanged
+    if (!m_pendingProgress.isEmpty()) {
+        int first = -1;
+        for (int row = 0, c = m_transactions.count(); row <= c; ++row) {
+            const bool pending = row < c && m_pendingProgress.contains(m_transactions[row]);
+            if (pending && first < 0) {
+                first = row;
+            } else if (!pending && first >= 0) {
+                Q_EMIT dataChanged(index(first), index(row - 1), {ProgressRole});
+                first = -1;
+            }
         }
+        m_pendingProgress.clear();
+    }
+
+    const int newProgress = progress();
+    if (newProgress != m_lastProgress) {
+        m_lastProgress = newProgress;
+        Q_EMIT progressChanged();
     }
-    return count == 0 ? 0 : sum / count;
 }
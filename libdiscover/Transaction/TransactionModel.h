@@ -8,11 +8,14 @@
 #define TRANSACTIONMODEL_H
 
 #include <QAbstractListModel>
+#include <QSet>
 
 #include "Transaction.h"
 
 #include "discovercommon_export.h"
 
+class QTimer;
+
 class DISCOVERCOMMON_EXPORT TransactionModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -46,7 +49,7 @@ public:
 
     bool contains(Transaction *transaction) const
     {
-        return m_transactions.contains(transaction);
+        return m_rows.contains(transaction);
     }
     int progress() const;
     QVector<Transaction *> transactions() const
@@ -55,7 +58,22 @@ public:
     }
 
 private:
+    void updateProgress(Transaction *trans);
+    void flushProgress();
+
     QVector<Transaction *> m_transactions;
+    QHash<Transaction *, int> m_rows;
+    QHash<AbstractResource *, Transaction *> m_transactionByResource;
+
+    // What each transaction adds up to progress(), -1 when it's not taken into account
+    QHash<Transaction *, int> m_progressContributions;
+    int m_progressSum = 0;
+    int m_progressCount = 0;
+    int m_lastProgress = 0;
+
+    // Progress changes are gathered and notified at most once per frame
+    QSet<Transaction *> m_pendingProgress;
+    QTimer *const m_progressTimer;
 
 Q_SIGNALS:
     void startingFirstTransaction();
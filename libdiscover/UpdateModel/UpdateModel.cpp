@@ -20,6 +20,7 @@
 #include <resources/AbstractResource.h>
 #include <resources/ResourcesModel.h>
 #include <resources/ResourcesUpdatesModel.h>
+#include <utils.h>
 
 UpdateModel::UpdateModel(QObject *parent)
     : QAbstractListModel(parent)
@@ -212,6 +213,28 @@ void UpdateModel::integrateChangelog(const QString &changelog)
     emit dataChanged(idx, idx, {ChangelogRole});
 }
 
+static int sectionOrder(AbstractResource *res)
+{
+    switch (res->type()) {
+    case AbstractResource::Application:
+        return 0;
+    case AbstractResource::Addon:
+        return 1;
+    case AbstractResource::Technical:
+        return 2;
+    }
+    Q_UNREACHABLE();
+}
+
+static bool updateItemLessThan(UpdateItem *a, UpdateItem *b)
+{
+    const int sectionA = sectionOrder(a->resource());
+    const int sectionB = sectionOrder(b->resource());
+    if (sectionA != sectionB)
+        return sectionA < sectionB;
+    return a->resource()->nameSortKey().compare(b->resource()->nameSortKey()) < 0;
+}
+
 void UpdateModel::setResources(const QList<AbstractResource *> &resources)
 {
     if (resources == m_resources) {
@@ -219,36 +242,60 @@ void UpdateModel::setResources(const QList<AbstractResource *> &resources)
     }
     m_resources = resources;
 
-    beginResetModel();
-    qDeleteAll(m_updateItems);
-    m_updateItems.clear();
-
-    QVector<UpdateItem *> appItems, systemItems, addonItems;
-    foreach (AbstractResource *res, resources) {
-        connect(res, &AbstractResource::changelogFetched, this, &UpdateModel::integrateChangelog, Qt::UniqueConnection);
+    // Drop the items that aren't there anymore, in as few removals as possible
+    const QSet<AbstractResource *> newResources = kToSet(resources);
+    for (int row = m_updateItems.count() - 1; row >= 0;) {
+        if (newResources.contains(m_updateItems[row]->resource())) {
+            --row;
+            continue;
+        }
 
-        UpdateItem *updateItem = new UpdateItem(res);
+        const int last = row;
+        while (row > 0 && !newResources.contains(m_updateItems[row - 1]->resource()))
+            --row;
 
-        switch (res->type()) {
-        case AbstractResource::Technical:
-            systemItems += updateItem;
-            break;
-        case AbstractResource::Application:
-            appItems += updateItem;
-            break;
-        case AbstractResource::Addon:
-            addonItems += updateItem;
-            break;
+        beginRemoveRows({}, row, last);
+        for (int i = row; i <= last; ++i) {
+            m_itemByResource.remove(m_updateItems[i]->resource());
+            delete m_updateItems[i];
         }
+        m_updateItems.remove(row, last - row + 1);
+        endRemoveRows();
+        --row;
+    }
+
+    AbstractResource::prepareNameSortKeys(resources.toVector());
+
+    // Keep existing items (and their changelog), only create the missing ones
+    QVector<UpdateItem *> newItems;
+    for (AbstractResource *res : resources) {
+        if (m_itemByResource.contains(res))
+            continue;
+
+        connect(res, &AbstractResource::changelogFetched, this, &UpdateModel::integrateChangelog, Qt::UniqueConnection);
+        UpdateItem *updateItem = new UpdateItem(res);
+        m_itemByResource.insert(res, updateItem);
+        newItems += updateItem;
+    }
+    std::sort(newItems.begin(), newItems.end(), updateItemLessThan);
+
+    // Merge them in, inserting consecutive items as a single range
+    int from = 0;
+    for (int i = 0, c = newItems.count(); i < c;) {
+        const auto it = std::lower_bound(m_updateItems.begin() + from, m_updateItems.end(), newItems[i], updateItemLessThan);
+        const int row = it - m_updateItems.begin();
+        int j = i + 1;
+        while (j < c && (row == m_updateItems.count() || updateItemLessThan(newItems[j], m_updateItems[row])))
+            ++j;
+
+        beginInsertRows({}, row, row + j - i - 1);
+        m_updateItems.insert(row, j - i, nullptr);
+        std::copy(newItems.constBegin() + i, newItems.constBegin() + j, m_updateItems.begin() + row);
+        endInsertRows();
+
+        from = row + j - i;
+        i = j;
     }
-    const auto sortUpdateItems = [](UpdateItem *a, UpdateItem *b) {
-        return a->name() < b->name();
-    };
-    std::sort(appItems.begin(), appItems.end(), sortUpdateItems);
-    std::sort(systemItems.begin(), systemItems.end(), sortUpdateItems);
-    std::sort(addonItems.begin(), addonItems.end(), sortUpdateItems);
-    m_updateItems = (QVector<UpdateItem *>() << appItems << addonItems << systemItems);
-    endResetModel();
 
     Q_EMIT hasUpdatesChanged(!resources.isEmpty());
     Q_EMIT toUpdateChanged();
@@ -296,11 +343,7 @@ int UpdateModel::totalUpdatesCount() const
 
 UpdateItem *UpdateModel::itemFromResource(AbstractResource *res)
 {
-    foreach (UpdateItem *item, m_updateItems) {
-        if (item->app() == res)
-            return item;
-    }
-    return nullptr;
+    return m_itemByResource.value(res);
 }
 
 QString UpdateModel::updateSize() const
@@ -318,19 +361,35 @@ UpdateItem *UpdateModel::itemFromIndex(const QModelIndex &index) const
     return m_updateItems[index.row()];
 }
 
-void UpdateModel::resourceDataChanged(AbstractResource *res, const QVector<QByteArray> &properties)
+void UpdateModel::resourceDataChanged(const QVector<AbstractResource *> &resources, const QVector<QByteArray> &properties)
 {
-    auto item = itemFromResource(res);
-    if (!item)
+    const bool stateChanged = properties.contains("state");
+    const bool sizeChanged = !stateChanged && properties.contains("size");
+    if (!stateChanged && !sizeChanged)
         return;
 
-    const auto index = indexFromItem(item);
-    if (properties.contains("state"))
-        Q_EMIT dataChanged(index, index, {SizeRole, UpgradeTextRole});
-    else if (properties.contains("size")) {
-        Q_EMIT dataChanged(index, index, {SizeRole});
-        m_updateSizeTimer->start();
+    QSet<UpdateItem *> changed;
+    for (AbstractResource *res : resources) {
+        if (auto item = itemFromResource(res))
+            changed.insert(item);
+    }
+    if (changed.isEmpty())
+        return;
+
+    QVector<int> rows;
+    for (int row = 0, count = m_updateItems.count(); row < count; ++row) {
+        if (changed.contains(m_updateItems[row]))
+            rows += row;
+    }
+    for (const auto &range : kRowRanges(rows)) {
+        if (stateChanged)
+            Q_EMIT dataChanged(index(range.first, 0), index(range.second, 0), {SizeRole, UpgradeTextRole});
+        else
+            Q_EMIT dataChanged(index(range.first, 0), index(range.second, 0), {SizeRole});
     }
+
+    if (sizeChanged)
+        m_updateSizeTimer->start();
 }
 
 void UpdateModel::checkAll()
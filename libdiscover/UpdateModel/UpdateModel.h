@@ -77,7 +77,7 @@ Q_SIGNALS:
     void updateSizeChanged();
 
 private:
-    void resourceDataChanged(AbstractResource *res, const QVector<QByteArray> &properties);
+    void resourceDataChanged(const QVector<AbstractResource *> &resources, const QVector<QByteArray> &properties);
     void integrateChangelog(const QString &changelog);
     QModelIndex indexFromItem(UpdateItem *item) const;
     UpdateItem *itemFromResource(AbstractResource *res);
@@ -86,6 +86,7 @@ private:
 
     QTimer *const m_updateSizeTimer;
     QVector<UpdateItem *> m_updateItems;
+    QHash<AbstractResource *, UpdateItem *> m_itemByResource;
     ResourcesUpdatesModel *m_updates;
     QList<AbstractResource *> m_resources;
 };
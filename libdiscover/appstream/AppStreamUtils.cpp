@@ -13,6 +13,7 @@
 #include <QDebug>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QMap>
 #include <QUrlQuery>
 #if APPSTREAM_HAS_SPDX
 #include <AppStreamQt/spdx.h>
@@ -102,3 +103,32 @@ QStringList AppStreamUtils::appstreamIds(const QUrl &appstreamUrl)
     }
     return ret;
 }
+
+QString AppStreamUtils::normalizedAppstreamId(const QString &id)
+{
+    static const QLatin1String desktopPostfix(".desktop");
+    QString ret = id.toLower();
+    if (ret.endsWith(desktopPostfix))
+        ret.chop(desktopPostfix.size());
+    return ret;
+}
+
+QStringList AppStreamUtils::withDeprecatedAppstreamIds(const QStringList &appstreamIds)
+{
+    static const QMap<QString, QString> deprecatedAppstreamIds = {
+        {QStringLiteral("org.kde.krita.desktop"), QStringLiteral("krita.desktop")},
+        {QStringLiteral("org.kde.digikam.desktop"), QStringLiteral("digikam.desktop")},
+        {QStringLiteral("org.kde.ktorrent.desktop"), QStringLiteral("ktorrent.desktop")},
+        {QStringLiteral("org.kde.gcompris.desktop"), QStringLiteral("gcompris.desktop")},
+        {QStringLiteral("org.kde.kmymoney.desktop"), QStringLiteral("kmymoney.desktop")},
+        {QStringLiteral("org.kde.kolourpaint.desktop"), QStringLiteral("kolourpaint.desktop")},
+        {QStringLiteral("org.blender.blender.desktop"), QStringLiteral("blender.desktop")},
+    };
+
+    QStringList ret = appstreamIds;
+    auto it = deprecatedAppstreamIds.constFind(appstreamIds.first());
+    if (it != deprecatedAppstreamIds.constEnd()) {
+        ret << *it;
+    }
+    return ret;
+}
@@ -24,6 +24,12 @@ Q_DECL_EXPORT QJsonArray licenses(const AppStream::Component &appdata);
 
 Q_DECL_EXPORT QStringList appstreamIds(const QUrl &appstreamUrl);
 
+/// @returns @p id in a form that can be used as an index key, ignoring case and the .desktop suffix
+Q_DECL_EXPORT QString normalizedAppstreamId(const QString &id);
+
+/// @returns @p appstreamIds followed by the ids the first of them was known as before, if any
+Q_DECL_EXPORT QStringList withDeprecatedAppstreamIds(const QStringList &appstreamIds);
+
 }
 
 #endif
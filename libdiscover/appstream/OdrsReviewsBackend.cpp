@@ -28,7 +28,9 @@
 #include <QJsonObject>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
+#include <QSaveFile>
 #include <QStandardPaths>
+#include <QTimer>
 
 #include <QFutureWatcher>
 #include <QtConcurrentRun>
@@ -36,6 +38,15 @@
 // #define APIURL "http://127.0.0.1:5000/1.0/reviews/api"
 #define APIURL "https://odrs.gnome.org/1.0/reviews/api"
 
+static const int s_reviewsPageSize = 20;
+// Same as the ratings, in seconds
+static const int s_reviewsMaxAge = 60 * 60 * 24;
+static const int s_maxPrefetches = 2;
+// Only the last listed ones, the rest has likely scrolled away already
+static const int s_prefetchQueueSize = 20;
+
+static void pruneCachedReviews();
+
 OdrsReviewsBackend::OdrsReviewsBackend()
     : AbstractReviewsBackend(nullptr)
     , m_isFetching(false)
@@ -65,6 +76,8 @@ OdrsReviewsBackend::OdrsReviewsBackend()
     } else {
         parseRatings();
     }
+
+    QtConcurrent::run(pruneCachedReviews);
 }
 
 OdrsReviewsBackend::~OdrsReviewsBackend() noexcept
@@ -104,34 +117,206 @@ static QString userHash()
     return QString::fromUtf8(QCryptographicHash::hash(salted.toUtf8(), QCryptographicHash::Sha1).toHex());
 }
 
-void OdrsReviewsBackend::fetchReviews(AbstractResource *app, int page)
+static QString reviewsCacheDir()
 {
-    Q_UNUSED(page)
-    m_isFetching = true;
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/reviews/");
+}
+
+static QString reviewsCachePath(const QString &appstreamId)
+{
+    return reviewsCacheDir() + QString(appstreamId).replace(QLatin1Char('/'), QLatin1Char('_')) + QLatin1String(".json");
+}
+
+static bool isCacheFresh(const QFileInfo &info)
+{
+    return info.exists() && info.lastModified().secsTo(QDateTime::currentDateTime()) < s_reviewsMaxAge;
+}
+
+static bool isCacheFresh(const QString &path)
+{
+    return isCacheFresh(QFileInfo(path));
+}
+
+/// Reviews that aren't fresh are never used again, they'd only pile up for every application ever looked at
+static void pruneCachedReviews()
+{
+    const QDir dir(reviewsCacheDir());
+    const auto files = dir.entryInfoList({QStringLiteral("*.json")}, QDir::Files);
+    for (const QFileInfo &info : files) {
+        if (!isCacheFresh(info)) {
+            QFile::remove(info.absoluteFilePath());
+        }
+    }
+}
+
+/// @p complete tells whether @p reviews are all there are or just the first ones
+static void storeCachedReviews(const QString &appstreamId, const QJsonArray &reviews, bool complete)
+{
+    const QString path = reviewsCachePath(appstreamId);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    const QJsonDocument document(QJsonObject{
+        {QStringLiteral("complete"), complete},
+        {QStringLiteral("reviews"), reviews},
+    });
+    if (!file.open(QIODevice::WriteOnly) || file.write(document.toJson(QJsonDocument::Compact)) < 0 || !file.commit()) {
+        qCWarning(LIBDISCOVER_LOG) << "could not cache reviews" << path << file.errorString();
+    }
+}
+
+static bool loadCachedReviews(const QString &appstreamId, QJsonArray *reviews, bool *complete)
+{
+    const QString path = reviewsCachePath(appstreamId);
+    if (!isCacheFresh(path)) {
+        return false;
+    }
 
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QJsonObject object = QJsonDocument::fromJson(file.readAll()).object();
+    *reviews = object.value(QLatin1String("reviews")).toArray();
+    *complete = object.value(QLatin1String("complete")).toBool();
+    return true;
+}
+
+static QJsonArray reviewsPage(const QJsonArray &reviews, int page, bool complete, bool *canFetchMore)
+{
+    const int first = (page - 1) * s_reviewsPageSize;
+    const int end = qMin(first + s_reviewsPageSize, reviews.size());
+    QJsonArray ret;
+    for (int i = first; i < end; ++i) {
+        ret.append(reviews.at(i));
+    }
+    *canFetchMore = end < reviews.size() || !complete;
+    return ret;
+}
+
+QNetworkReply *OdrsReviewsBackend::requestReviews(AbstractResource *app, int limit, QNetworkRequest::Priority priority)
+{
     const QJsonDocument document(QJsonObject{
         {QStringLiteral("app_id"), app->appstreamId()},
         {QStringLiteral("distro"), osName()},
         {QStringLiteral("user_hash"), userHash()},
         {QStringLiteral("version"), app->isInstalled() ? app->installedVersion() : app->availableVersion()},
         {QStringLiteral("locale"), QLocale::system().name()},
-        {QStringLiteral("limit"), -1},
+        {QStringLiteral("limit"), limit},
     });
 
     const auto json = document.toJson(QJsonDocument::Compact);
     QNetworkRequest request(QUrl(QStringLiteral(APIURL "/fetch")));
     request.setHeader(QNetworkRequest::ContentTypeHeader, QStringLiteral("application/json; charset=utf-8"));
     request.setHeader(QNetworkRequest::ContentLengthHeader, json.size());
+    request.setPriority(priority);
     // Store reference to the app for which we request reviews
     request.setOriginatingObject(app);
 
-    auto reply = nam()->post(request, json);
-    connect(reply, &QNetworkReply::finished, this, &OdrsReviewsBackend::reviewsFetched);
+    return nam()->post(request, json);
 }
 
-void OdrsReviewsBackend::reviewsFetched()
+bool OdrsReviewsBackend::fetchCachedReviews(AbstractResource *app, int page)
+{
+    QJsonArray reviews;
+    bool complete = false;
+    if (!loadCachedReviews(app->appstreamId(), &reviews, &complete) || (!complete && reviews.size() < page * s_reviewsPageSize)) {
+        return false;
+    }
+
+    bool canFetchMore = false;
+    const QJsonArray pageReviews = reviewsPage(reviews, page, complete, &canFetchMore);
+    // Delivered later like the replies are, the model doesn't expect them while it's fetching
+    QPointer<AbstractResource> resource = app;
+    QTimer::singleShot(0, this, [this, resource, pageReviews, canFetchMore] {
+        if (resource) {
+            parseReviews(pageReviews, resource, canFetchMore);
+        } else {
+            m_isFetching = false;
+        }
+    });
+    return true;
+}
+
+void OdrsReviewsBackend::fetchReviews(AbstractResource *app, int page)
+{
+    m_isFetching = true;
+    if (fetchCachedReviews(app, page)) {
+        return;
+    }
+
+    const QString appstreamId = app->appstreamId();
+    if (m_prefetching.contains(appstreamId)) {
+        m_waitingForPrefetch.insert(appstreamId, {app, page});
+        return;
+    }
+
+    // ODRS doesn't take an offset. The first page is all most visits need, the rest comes at once when asked for
+    const int limit = page == 1 ? s_reviewsPageSize : -1;
+    auto reply = requestReviews(app, limit, QNetworkRequest::NormalPriority);
+    connect(reply, &QNetworkReply::finished, this, [this, reply, page, limit] {
+        reviewsFetched(reply, page, limit);
+    });
+}
+
+void OdrsReviewsBackend::prefetchReviews(AbstractResource *app)
+{
+    const QString appstreamId = app->appstreamId();
+    if (appstreamId.isEmpty() || m_prefetching.contains(appstreamId) || isCacheFresh(reviewsCachePath(appstreamId))) {
+        return;
+    }
+
+    m_prefetchQueue.removeAll(app);
+    m_prefetchQueue.append(app);
+    if (m_prefetchQueue.size() > s_prefetchQueueSize) {
+        m_prefetchQueue.removeFirst();
+    }
+    startPrefetches();
+}
+
+void OdrsReviewsBackend::startPrefetches()
+{
+    while (m_prefetching.size() < s_maxPrefetches && !m_prefetchQueue.isEmpty()) {
+        AbstractResource *app = m_prefetchQueue.takeLast();
+        if (!app || m_prefetching.contains(app->appstreamId())) {
+            continue;
+        }
+
+        const QString appstreamId = app->appstreamId();
+        m_prefetching.insert(appstreamId);
+        auto reply = requestReviews(app, s_reviewsPageSize, QNetworkRequest::LowPriority);
+        connect(reply, &QNetworkReply::finished, this, [this, reply, appstreamId] {
+            reviewsPrefetched(reply, appstreamId);
+        });
+    }
+}
+
+void OdrsReviewsBackend::reviewsPrefetched(QNetworkReply *reply, const QString &appstreamId)
+{
+    QScopedPointer<QNetworkReply, QScopedPointerDeleteLater> replyPtr(reply);
+    m_prefetching.remove(appstreamId);
+    if (reply->error() == QNetworkReply::NoError) {
+        const QJsonArray reviews = QJsonDocument::fromJson(reply->readAll()).array();
+        storeCachedReviews(appstreamId, reviews, reviews.size() < s_reviewsPageSize);
+    } else {
+        qCWarning(LIBDISCOVER_LOG) << "could not prefetch reviews for" << appstreamId << reply->errorString();
+    }
+
+    // The application page was opened meanwhile, it gets them from the cache or asks again
+    const auto it = m_waitingForPrefetch.find(appstreamId);
+    if (it != m_waitingForPrefetch.end()) {
+        const PendingFetch pending = *it;
+        m_waitingForPrefetch.erase(it);
+        if (pending.resource) {
+            fetchReviews(pending.resource, pending.page);
+        } else {
+            m_isFetching = false;
+        }
+    }
+    startPrefetches();
+}
+
+void OdrsReviewsBackend::reviewsFetched(QNetworkReply *reply, int page, int limit)
 {
-    QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
     QScopedPointer<QNetworkReply, QScopedPointerDeleteLater> replyPtr(reply);
     const QByteArray data = reply->readAll();
     const auto networkError = reply->error();
@@ -142,10 +327,20 @@ void OdrsReviewsBackend::reviewsFetched()
         return;
     }
 
-    const QJsonDocument document = QJsonDocument::fromJson(data);
+    const QJsonArray reviews = QJsonDocument::fromJson(data).array();
     AbstractResource *resource = qobject_cast<AbstractResource *>(reply->request().originatingObject());
     Q_ASSERT(resource);
-    parseReviews(document, resource);
+    if (!resource) {
+        m_isFetching = false;
+        return;
+    }
+
+    const bool complete = limit < 0 || reviews.size() < limit;
+    storeCachedReviews(resource->appstreamId(), reviews, complete);
+
+    bool canFetchMore = !complete;
+    const QJsonArray pageReviews = limit < 0 ? reviewsPage(reviews, page, complete, &canFetchMore) : reviews;
+    parseReviews(pageReviews, resource, canFetchMore);
 }
 
 Rating *OdrsReviewsBackend::ratingForApplication(AbstractResource *app) const
@@ -234,8 +429,9 @@ void OdrsReviewsBackend::reviewSubmitted(QNetworkReply *reply)
         Q_ASSERT(resource);
         qCWarning(LIBDISCOVER_LOG) << "Review submitted" << resource;
         if (resource) {
-            const QJsonDocument document({resource->getMetadata(QStringLiteral("ODRS::review_map")).toObject()});
-            parseReviews(document, resource);
+            // Not in the cached reviews yet, they're fetched again next time
+            QFile::remove(reviewsCachePath(resource->appstreamId()));
+            parseReviews(QJsonArray{resource->getMetadata(QStringLiteral("ODRS::review_map")).toObject()}, resource, false);
         } else {
             qCWarning(LIBDISCOVER_LOG) << "Failed to submit review: missing object";
         }
@@ -281,7 +477,7 @@ void OdrsReviewsBackend::parseRatings()
     }));
 }
 
-void OdrsReviewsBackend::parseReviews(const QJsonDocument &document, AbstractResource *resource)
+void OdrsReviewsBackend::parseReviews(const QJsonArray &reviews, AbstractResource *resource, bool canFetchMore)
 {
     m_isFetching = false;
     Q_ASSERT(resource);
@@ -289,43 +485,41 @@ void OdrsReviewsBackend::parseReviews(const QJsonDocument &document, AbstractRes
         return;
     }
 
-    QJsonArray reviews = document.array();
-    if (!reviews.isEmpty()) {
-        QVector<ReviewPtr> reviewList;
-        for (auto it = reviews.begin(); it != reviews.end(); it++) {
-            const QJsonObject review = it->toObject();
-            if (!review.isEmpty()) {
-                const int usefulFavorable = review.value(QStringLiteral("karma_up")).toInt();
-                const int usefulTotal = review.value(QStringLiteral("karma_down")).toInt() + usefulFavorable;
-                QDateTime dateTime;
-                dateTime.setSecsSinceEpoch(review.value(QStringLiteral("date_created")).toInt());
-                ReviewPtr r(new Review(review.value(QStringLiteral("app_id")).toString(),
-                                       resource->packageName(),
-                                       review.value(QStringLiteral("locale")).toString(),
-                                       review.value(QStringLiteral("summary")).toString(),
-                                       review.value(QStringLiteral("description")).toString(),
-                                       review.value(QStringLiteral("user_display")).toString(),
-                                       dateTime,
-                                       true,
-                                       review.value(QStringLiteral("review_id")).toInt(),
-                                       review.value(QStringLiteral("rating")).toInt() / 10,
-                                       usefulTotal,
-                                       usefulFavorable,
-                                       review.value(QStringLiteral("version")).toString()));
-                // We can also receive just a json with app name and user info so filter these out as there is no review
-                if (!r->summary().isEmpty() && !r->reviewText().isEmpty()) {
-                    reviewList << r;
-                    // Needed for submitting usefulness
-                    r->addMetadata(QStringLiteral("ODRS::user_skey"), review.value(QStringLiteral("user_skey")).toString());
-                }
-
-                // We should get at least user_skey needed for posting reviews
-                resource->addMetadata(QStringLiteral("ODRS::user_skey"), review.value(QStringLiteral("user_skey")).toString());
+    QVector<ReviewPtr> reviewList;
+    reviewList.reserve(reviews.size());
+    for (auto it = reviews.begin(); it != reviews.end(); it++) {
+        const QJsonObject review = it->toObject();
+        if (!review.isEmpty()) {
+            const int usefulFavorable = review.value(QStringLiteral("karma_up")).toInt();
+            const int usefulTotal = review.value(QStringLiteral("karma_down")).toInt() + usefulFavorable;
+            QDateTime dateTime;
+            dateTime.setSecsSinceEpoch(review.value(QStringLiteral("date_created")).toInt());
+            ReviewPtr r(new Review(review.value(QStringLiteral("app_id")).toString(),
+                                   resource->packageName(),
+                                   review.value(QStringLiteral("locale")).toString(),
+                                   review.value(QStringLiteral("summary")).toString(),
+                                   review.value(QStringLiteral("description")).toString(),
+                                   review.value(QStringLiteral("user_display")).toString(),
+                                   dateTime,
+                                   true,
+                                   review.value(QStringLiteral("review_id")).toInt(),
+                                   review.value(QStringLiteral("rating")).toInt() / 10,
+                                   usefulTotal,
+                                   usefulFavorable,
+                                   review.value(QStringLiteral("version")).toString()));
+            // We can also receive just a json with app name and user info so filter these out as there is no review
+            if (!r->summary().isEmpty() && !r->reviewText().isEmpty()) {
+                reviewList << r;
+                // Needed for submitting usefulness
+                r->addMetadata(QStringLiteral("ODRS::user_skey"), review.value(QStringLiteral("user_skey")).toString());
             }
-        }
 
-        Q_EMIT reviewsReady(resource, reviewList, false);
+            // We should get at least user_skey needed for posting reviews
+            resource->addMetadata(QStringLiteral("ODRS::user_skey"), review.value(QStringLiteral("user_skey")).toString());
+        }
     }
+
+    Q_EMIT reviewsReady(resource, reviewList, canFetchMore);
 }
 
 bool OdrsReviewsBackend::isResourceSupported(AbstractResource *res) const
@@ -11,9 +11,12 @@
 #include <ReviewsBackend/AbstractReviewsBackend.h>
 #include <ReviewsBackend/ReviewsModel.h>
 
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QMap>
 #include <QNetworkReply>
+#include <QPointer>
+#include <QSet>
 
 class KJob;
 class AbstractResourcesBackend;
@@ -46,6 +49,7 @@ public:
     {
     }
     void fetchReviews(AbstractResource *app, int page = 1) override;
+    void prefetchReviews(AbstractResource *app) override;
     bool isFetching() const override
     {
         return m_isFetching;
@@ -60,7 +64,8 @@ public:
 
 private Q_SLOTS:
     void ratingsFetched(KJob *job);
-    void reviewsFetched();
+    void reviewsFetched(QNetworkReply *reply, int page, int limit);
+    void reviewsPrefetched(QNetworkReply *reply, const QString &appstreamId);
     void reviewSubmitted(QNetworkReply *reply);
     void usefulnessSubmitted();
 
@@ -70,11 +75,22 @@ Q_SIGNALS:
 private:
     QNetworkAccessManager *nam();
     void parseRatings();
-    void parseReviews(const QJsonDocument &document, AbstractResource *resource);
+    QNetworkReply *requestReviews(AbstractResource *app, int limit, QNetworkRequest::Priority priority);
+    bool fetchCachedReviews(AbstractResource *app, int page);
+    void startPrefetches();
+    void parseReviews(const QJsonArray &reviews, AbstractResource *resource, bool canFetchMore);
+
+    struct PendingFetch {
+        QPointer<AbstractResource> resource;
+        int page;
+    };
 
     QHash<QString, Rating *> m_ratings;
     bool m_isFetching;
     CachedNetworkAccessManager *m_delayedNam = nullptr;
+    QVector<QPointer<AbstractResource>> m_prefetchQueue;
+    QSet<QString> m_prefetching;
+    QHash<QString, PendingFetch> m_waitingForPrefetch;
 };
 
 #endif // ODRSREVIEWSBACKEND_H
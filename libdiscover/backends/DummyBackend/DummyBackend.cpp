@@ -19,6 +19,7 @@
 #include <KPluginFactory>
 #include <KSharedConfig>
 #include <QDebug>
+#include <QRandomGenerator>
 #include <QThread>
 #include <QTimer>
 
@@ -35,7 +36,12 @@ DummyBackend::DummyBackend(QObject *parent)
     connect(m_reviews, &DummyReviewsBackend::ratingsReady, this, &AbstractResourcesBackend::emitRatingsReady);
     connect(m_updater, &StandardBackendUpdater::updatesCountChanged, this, &DummyBackend::updatesCountChanged);
 
-    populate(QStringLiteral("Dummy"));
+    // Allows benchmarks to work on a catalog of a realistic size, see DummyBenchmark
+    const int catalogSize = qEnvironmentVariableIntValue("DISCOVER_DUMMY_CATALOG_SIZE");
+    if (catalogSize > 0)
+        populateCatalog(catalogSize);
+    else
+        populate(QStringLiteral("Dummy"));
     if (!m_fetching)
         m_reviews->initialize();
 
@@ -73,6 +79,77 @@ void DummyBackend::populate(const QString &n)
     }
 }
 
+void DummyBackend::populateCatalog(int size)
+{
+    static const QVector<QLatin1String> prefixes = {QLatin1String("K"),
+                                                    QLatin1String("Open"),
+                                                    QLatin1String("Libre"),
+                                                    QLatin1String("Gnu"),
+                                                    QLatin1String("Super"),
+                                                    QLatin1String("Tiny"),
+                                                    QLatin1String("Quick"),
+                                                    QLatin1String("Deep"),
+                                                    QLatin1String("Pixel"),
+                                                    QLatin1String("Cloud"),
+                                                    QLatin1String("Smart"),
+                                                    QLatin1String("Plasma")};
+    static const QVector<QLatin1String> nouns = {QLatin1String("Writer"),
+                                                 QLatin1String("Paint"),
+                                                 QLatin1String("Player"),
+                                                 QLatin1String("Mail"),
+                                                 QLatin1String("Calc"),
+                                                 QLatin1String("Browser"),
+                                                 QLatin1String("Notes"),
+                                                 QLatin1String("Chess"),
+                                                 QLatin1String("Terminal"),
+                                                 QLatin1String("Studio"),
+                                                 QLatin1String("Viewer"),
+                                                 QLatin1String("Scanner"),
+                                                 QLatin1String("Planner"),
+                                                 QLatin1String("Radio"),
+                                                 QLatin1String("Weather"),
+                                                 QLatin1String("Backup"),
+                                                 QLatin1String("Editor"),
+                                                 QLatin1String("Maps"),
+                                                 QLatin1String("Photos"),
+                                                 QLatin1String("Chat")};
+    static const QVector<QLatin1String> xdgCategories = {QLatin1String("Office"),
+                                                         QLatin1String("Graphics"),
+                                                         QLatin1String("AudioVideo"),
+                                                         QLatin1String("Network"),
+                                                         QLatin1String("Game"),
+                                                         QLatin1String("Development"),
+                                                         QLatin1String("Education"),
+                                                         QLatin1String("Utility")};
+    static const QVector<QLatin1String> dummyCategories = {QLatin1String("dummy1"), QLatin1String("dummy2"), QLatin1String("dummy3")};
+
+    const int combinations = prefixes.size() * nouns.size();
+    QRandomGenerator generator(size);
+    m_resources.reserve(m_resources.size() + size);
+    for (int i = 0; i < size; ++i) {
+        const int combination = i % combinations;
+        QString name = QString(prefixes[combination % prefixes.size()]) + nouns[combination / prefixes.size()];
+        if (i >= combinations)
+            name += QStringLiteral(" %1").arg(i / combinations);
+
+        // Roughly the mix of a distribution repository: mostly applications, many available, a few upgradeable
+        const int typeDice = generator.bounded(100);
+        const auto type = typeDice < 70 ? AbstractResource::Application : typeDice < 85 ? AbstractResource::Addon : AbstractResource::Technical;
+        const int stateDice = generator.bounded(100);
+        const auto state = stateDice < 65 ? AbstractResource::None : stateDice < 92 ? AbstractResource::Installed : AbstractResource::Upgradeable;
+
+        DummyResource *res = new DummyResource(name, type, this);
+        res->setSize(generator.bounded(10 * 1024, 500 * 1024 * 1024));
+        res->setState(state);
+        res->setCategories({QStringLiteral("dummy"),
+                            dummyCategories[i % dummyCategories.size()],
+                            name.endsWith(QLatin1Char('3')) ? QStringLiteral("three") : QStringLiteral("notthree"),
+                            xdgCategories[generator.bounded(xdgCategories.size())]});
+        m_resources.insert(name.toLower(), res);
+        connect(res, &DummyResource::stateChanged, this, &DummyBackend::updatesCountChanged);
+    }
+}
+
 void DummyBackend::toggleFetching()
 {
     m_fetching = !m_fetching;
@@ -145,6 +222,27 @@ Transaction *DummyBackend::installApplication(AbstractResource *app)
     return new DummyTransaction(qobject_cast<DummyResource *>(app), Transaction::InstallRole);
 }
 
+void DummyBackend::queueInstall(DummyTransaction *transaction)
+{
+    if (m_installQueue.isEmpty())
+        QTimer::singleShot(0, this, &DummyBackend::flushInstallQueue);
+    m_installQueue += transaction;
+}
+
+void DummyBackend::flushInstallQueue()
+{
+    QVector<DummyTransaction *> batch;
+    for (const auto &transaction : qExchange(m_installQueue, {})) {
+        if (transaction && transaction->status() == Transaction::QueuedStatus)
+            batch += transaction;
+    }
+
+    if (!batch.isEmpty()) {
+        auto leader = batch.takeFirst();
+        leader->startBatch(batch);
+    }
+}
+
 Transaction *DummyBackend::removeApplication(AbstractResource *app)
 {
     return new DummyTransaction(qobject_cast<DummyResource *>(app), Transaction::RemoveRole);
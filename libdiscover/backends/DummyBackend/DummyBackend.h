@@ -7,16 +7,20 @@
 #ifndef DUMMYBACKEND_H
 #define DUMMYBACKEND_H
 
+#include <QPointer>
 #include <QVariantList>
 #include <resources/AbstractResourcesBackend.h>
 
 class DummyReviewsBackend;
 class StandardBackendUpdater;
 class DummyResource;
+class DummyTransaction;
 class DummyBackend : public AbstractResourcesBackend
 {
     Q_OBJECT
     Q_PROPERTY(int startElements MEMBER m_startElements)
+    /// Installs the applications requested in the same event loop turn together, like PackageKitBackend
+    Q_PROPERTY(bool batchInstalls MEMBER m_batchInstalls)
 public:
     explicit DummyBackend(QObject *parent = nullptr);
 
@@ -45,17 +49,27 @@ public:
     QString displayName() const override;
     bool hasApplications() const override;
 
+    bool batchInstalls() const
+    {
+        return m_batchInstalls;
+    }
+    void queueInstall(DummyTransaction *transaction);
+
 public Q_SLOTS:
     void toggleFetching();
 
 private:
     void populate(const QString &name);
+    void populateCatalog(int size);
+    void flushInstallQueue();
 
     QHash<QString, DummyResource *> m_resources;
     StandardBackendUpdater *m_updater;
     DummyReviewsBackend *m_reviews;
     bool m_fetching;
     int m_startElements;
+    bool m_batchInstalls = false;
+    QVector<QPointer<DummyTransaction>> m_installQueue;
 };
 
 #endif // DUMMYBACKEND_H
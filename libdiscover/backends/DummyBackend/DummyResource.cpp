@@ -57,6 +57,8 @@ QString DummyResource::availableVersion() const
 
 QStringList DummyResource::categories()
 {
+    if (!m_categories.isEmpty())
+        return m_categories;
     return {QStringLiteral("dummy"), m_name.endsWith(QLatin1Char('3')) ? QStringLiteral("three") : QStringLiteral("notthree")};
 }
 
@@ -13,6 +13,7 @@ class AddonList;
 class DummyResource : public AbstractResource
 {
     Q_OBJECT
+    Q_PROPERTY(bool failsToInstall MEMBER m_failsToInstall)
 public:
     explicit DummyResource(QString name, AbstractResource::Type type, AbstractResourcesBackend *parent);
 
@@ -56,6 +57,10 @@ public:
         m_size = size;
     }
     void setAddons(const AddonList &addons);
+    void setCategories(const QStringList &categories)
+    {
+        m_categories = categories;
+    }
 
     void setAddonInstalled(const QString &addon, bool installed);
     QString sourceIcon() const override
@@ -74,8 +79,10 @@ public:
     QList<QUrl> m_screenshotThumbnails;
     QString m_iconName;
     QList<PackageState> m_addons;
+    QStringList m_categories;
     const AbstractResource::Type m_type;
     int m_size;
+    bool m_failsToInstall = false;
 };
 
 #endif // DUMMYRESOURCE_H
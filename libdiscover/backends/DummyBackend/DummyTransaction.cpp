@@ -10,6 +10,7 @@
 #include <KRandom>
 #include <QDebug>
 #include <QTimer>
+#include <utils.h>
 
 // #define TEST_PROCEED
 
@@ -23,21 +24,60 @@ DummyTransaction::DummyTransaction(DummyResource *app, const AddonList &addons,
     , m_app(app)
 {
     setCancellable(true);
+
+    auto backend = qobject_cast<DummyBackend *>(app->backend());
+    if (role == InstallRole && addons.isEmpty() && backend->batchInstalls()) {
+        setStatus(QueuedStatus);
+        backend->queueInstall(this);
+        return;
+    }
+
     setStatus(DownloadingStatus);
+    iterateTransaction();
+}
 
+void DummyTransaction::startBatch(const QVector<DummyTransaction *> &followers)
+{
+    for (auto follower : followers) {
+        m_followers += follower;
+        follower->m_leader = this;
+    }
+
+    for (auto member : batchMembers())
+        member->setStatus(DownloadingStatus);
     iterateTransaction();
 }
 
+QVector<DummyTransaction *> DummyTransaction::batchMembers() const
+{
+    QVector<DummyTransaction *> ret = {const_cast<DummyTransaction *>(this)};
+    for (const auto &follower : m_followers) {
+        if (follower)
+            ret += follower;
+    }
+    return ret;
+}
+
+bool DummyTransaction::failsToInstall() const
+{
+    return role() == InstallRole && m_app->m_failsToInstall;
+}
+
 void DummyTransaction::iterateTransaction()
 {
-    if (!m_iterate)
+    // Followers are driven by their leader
+    if (!m_iterate || m_leader)
         return;
 
+    const auto members = batchMembers();
     if (progress() < 100) {
-        setProgress(qBound(0, progress() + (KRandom::random() % 30), 100));
+        const int newProgress = qBound(0, progress() + (KRandom::random() % 30), 100);
+        for (auto member : members)
+            member->setProgress(newProgress);
         QTimer::singleShot(/*KRandom::random()%*/ 100, this, &DummyTransaction::iterateTransaction);
     } else if (status() == DownloadingStatus) {
-        setStatus(CommittingStatus);
+        for (auto member : members)
+            member->setStatus(CommittingStatus);
         QTimer::singleShot(/*KRandom::random()%*/ 100, this, &DummyTransaction::iterateTransaction);
     } else
 #ifdef TEST_PROCEED
@@ -56,12 +96,59 @@ void DummyTransaction::proceed()
 
 void DummyTransaction::cancel()
 {
+    if (m_leader) {
+        // Only we leave the batch, the leader keeps installing the rest
+        m_leader->m_followers.removeAll(this);
+        m_leader = nullptr;
+    } else if (!m_followers.isEmpty()) {
+        // The first follower takes over the rest of the batch where we left it
+        auto members = batchMembers();
+        members.removeFirst();
+        m_followers.clear();
+        if (!members.isEmpty()) {
+            auto leader = members.takeFirst();
+            leader->m_leader = nullptr;
+            for (auto follower : qAsConst(members)) {
+                follower->m_leader = leader;
+                leader->m_followers += follower;
+            }
+            leader->iterateTransaction();
+        }
+    }
     m_iterate = false;
 
     setStatus(CancelledStatus);
 }
 
 void DummyTransaction::finishTransaction()
+{
+    const auto members = batchMembers();
+    const bool failed = kContains(members, [](DummyTransaction *member) {
+        return member->failsToInstall();
+    });
+    if (failed && members.size() > 1) {
+        // Like PKTransaction, find out which resources fail by installing them one by one
+        m_followers.clear();
+        for (auto member : members) {
+            member->m_leader = nullptr;
+            member->setProgress(0);
+            member->setStatus(DownloadingStatus);
+            member->iterateTransaction();
+        }
+        return;
+    }
+
+    for (auto member : members) {
+        if (member->failsToInstall()) {
+            member->setStatus(DoneWithErrorStatus);
+            member->deleteLater();
+        } else {
+            member->applyChanges();
+        }
+    }
+}
+
+void DummyTransaction::applyChanges()
 {
     AbstractResource::State newState;
     switch (role()) {
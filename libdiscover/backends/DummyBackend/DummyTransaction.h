@@ -7,6 +7,7 @@
 #ifndef DUMMYTRANSACTION_H
 #define DUMMYTRANSACTION_H
 
+#include <QPointer>
 #include <Transaction/Transaction.h>
 
 class DummyResource;
@@ -20,13 +21,22 @@ public:
     void cancel() override;
     void proceed() override;
 
+    /// Installs @p followers along with us, with the same per resource outcome as PKTransaction::startBatch
+    void startBatch(const QVector<DummyTransaction *> &followers);
+
 private Q_SLOTS:
     void iterateTransaction();
     void finishTransaction();
 
 private:
+    QVector<DummyTransaction *> batchMembers() const;
+    bool failsToInstall() const;
+    void applyChanges();
+
     bool m_iterate = true;
     DummyResource *m_app;
+    QPointer<DummyTransaction> m_leader;
+    QVector<QPointer<DummyTransaction>> m_followers;
 };
 
 #endif // DUMMYTRANSACTION_H
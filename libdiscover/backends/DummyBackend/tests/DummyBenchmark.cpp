@@ -0,0 +1,334 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include <Category/Category.h>
+#include <Category/CategoryModel.h>
+#include <DiscoverBackendsFactory.h>
+#include <Transaction/Transaction.h>
+#include <Transaction/TransactionModel.h>
+#include <UpdateModel/UpdateModel.h>
+#include <resources/ResourcesModel.h>
+#include <resources/ResourcesProxyModel.h>
+#include <resources/ResourcesUpdatesModel.h>
+
+#include <QDir>
+#include <QStandardPaths>
+#include <QTest>
+#include <QtTest>
+
+/**
+ * Measures the hot paths of libdiscover over a big DummyBackend catalog.
+ *
+ * The catalog size is taken from DISCOVER_DUMMY_CATALOG_SIZE (10000 resources by default).
+ * Run with "-o results.csv,csv" (as ctest does) to get machine-readable results to compare runs.
+ */
+
+class BenchmarkTransaction : public Transaction
+{
+public:
+    BenchmarkTransaction(AbstractResource *res)
+        : Transaction(res, res, Transaction::InstallRole)
+    {
+        setStatus(DownloadingStatus);
+    }
+
+    void cancel() override
+    {
+        setStatus(CancelledStatus);
+    }
+};
+
+static QVector<Category *> allCategories(const QVector<Category *> &cats)
+{
+    QVector<Category *> ret = cats;
+    for (Category *cat : cats) {
+        ret += allCategories(cat->subCategories());
+    }
+    return ret;
+}
+
+class DummyBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    DummyBenchmark(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+        // The cold runs wipe the categories cache, keep away from the user's
+        QStandardPaths::setTestModeEnabled(true);
+
+        if (!qEnvironmentVariableIsSet("DISCOVER_DUMMY_CATALOG_SIZE"))
+            qputenv("DISCOVER_DUMMY_CATALOG_SIZE", "10000");
+
+        DiscoverBackendsFactory::setRequestedBackends({QStringLiteral("dummy-backend")});
+        m_model = new ResourcesModel(QStringLiteral("dummy-backend"), this);
+        m_appBackend = m_model->backends().value(0);
+
+        CategoryModel::global()->populateCategories();
+    }
+
+    QVector<AbstractResource *> fetchResources(ResultsStream *stream)
+    {
+        QVector<AbstractResource *> ret;
+        connect(stream, &ResultsStream::resourcesFound, this, [&ret](const QVector<AbstractResource *> &res) {
+            ret += res;
+        });
+        QSignalSpy spy(stream, &ResultsStream::destroyed);
+        spy.wait();
+        return ret;
+    }
+
+    void waitForProxy(ResourcesProxyModel *pm)
+    {
+        QSignalSpy spy(pm, &ResourcesProxyModel::busyChanged);
+        while (pm->isBusy()) {
+            QVERIFY(spy.wait());
+        }
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QVERIFY(m_appBackend);
+        while (m_appBackend->isFetching()) {
+            QSignalSpy spy(m_appBackend, &AbstractResourcesBackend::fetchingChanged);
+            QVERIFY(spy.wait());
+        }
+        qInfo() << "benchmarking a catalog of" << qEnvironmentVariableIntValue("DISCOVER_DUMMY_CATALOG_SIZE") << "resources";
+    }
+
+    void benchmarkSearch_data()
+    {
+        QTest::addColumn<QString>("search");
+        QTest::newRow("frequent") << QStringLiteral("writer");
+        QTest::newRow("rare") << QStringLiteral("plasmaweather 3");
+        QTest::newRow("none") << QStringLiteral("nothingmatchesthis");
+    }
+
+    void benchmarkSearch()
+    {
+        QFETCH(QString, search);
+        AbstractResourcesBackend::Filters filter;
+        filter.search = search;
+
+        QBENCHMARK {
+            fetchResources(m_appBackend->search(filter));
+        }
+    }
+
+    void benchmarkProxySorting_data()
+    {
+        QTest::addColumn<ResourcesProxyModel::Roles>("role");
+        QTest::newRow("name") << ResourcesProxyModel::NameRole;
+        QTest::newRow("rating") << ResourcesProxyModel::SortableRatingRole;
+        QTest::newRow("size") << ResourcesProxyModel::SizeRole;
+    }
+
+    void benchmarkProxySorting()
+    {
+        QFETCH(ResourcesProxyModel::Roles, role);
+
+        ResourcesProxyModel pm;
+        pm.setFiltersFromCategory(CategoryModel::global()->rootCategories().constFirst());
+        pm.componentComplete();
+        waitForProxy(&pm);
+        QVERIFY(pm.rowCount() > 0);
+
+        pm.setSortRole(role);
+        QBENCHMARK {
+            pm.invalidateSorting();
+        }
+    }
+
+    void benchmarkProxyFiltering_data()
+    {
+        QTest::addColumn<QString>("search");
+        QTest::newRow("frequent") << QStringLiteral("writer");
+        QTest::newRow("rare") << QStringLiteral("plasmaweather 3");
+    }
+
+    void benchmarkProxyFiltering()
+    {
+        QFETCH(QString, search);
+
+        ResourcesProxyModel pm;
+        pm.setFiltersFromCategory(CategoryModel::global()->rootCategories().constFirst());
+        pm.componentComplete();
+        waitForProxy(&pm);
+
+        // Every iteration filters and goes back to the full category listing
+        QBENCHMARK {
+            pm.setSearch(search);
+            waitForProxy(&pm);
+            pm.setSearch({});
+            waitForProxy(&pm);
+        }
+    }
+
+    void benchmarkProxyUpdates_data()
+    {
+        QTest::addColumn<QByteArray>("property");
+        QTest::newRow("data") << QByteArray("longDescription");
+        QTest::newRow("sorting") << QByteArray("size");
+    }
+
+    void benchmarkProxyUpdates()
+    {
+        QFETCH(QByteArray, property);
+
+        ResourcesProxyModel pm;
+        pm.setFiltersFromCategory(CategoryModel::global()->rootCategories().constFirst());
+        pm.setSortRole(ResourcesProxyModel::SizeRole);
+        pm.componentComplete();
+        waitForProxy(&pm);
+        const int rows = pm.rowCount();
+        const int updates = qMin(10000, rows);
+        QVERIFY(updates > 0);
+
+        QVector<AbstractResource *> resources;
+        resources.reserve(updates);
+        for (int i = 0; i < updates; ++i) {
+            resources += pm.resourceAt(int(qint64(i) * rows / updates));
+        }
+
+        // Each change on its own, as when a backend reports them as they come
+        QBENCHMARK {
+            for (AbstractResource *res : qAsConst(resources)) {
+                Q_EMIT ResourcesModel::global()->resourceDataChanged({res}, {property});
+                QVERIFY(pm.indexOf(res) >= 0);
+            }
+        }
+        QCOMPARE(pm.rowCount(), rows);
+    }
+
+    void benchmarkPopulateCategories_data()
+    {
+        QTest::addColumn<bool>("cold");
+        QTest::newRow("cold") << true;
+        QTest::newRow("warm") << false;
+    }
+
+    void benchmarkPopulateCategories()
+    {
+        QFETCH(bool, cold);
+        QDir cacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/categories"));
+
+        // A cold run parses the categories files again, a warm one reads the cache left by the previous iteration
+        CategoryModel::global()->populateCategories();
+        QBENCHMARK {
+            if (cold)
+                cacheDir.removeRecursively();
+            CategoryModel::global()->populateCategories();
+        }
+        QVERIFY(!CategoryModel::global()->rootCategories().isEmpty());
+    }
+
+    void benchmarkCategoryMatching()
+    {
+        const auto categories = allCategories(CategoryModel::global()->rootCategories());
+        const auto resources = fetchResources(m_appBackend->search({}));
+        QVERIFY(!categories.isEmpty());
+        QVERIFY(!resources.isEmpty());
+
+        QBENCHMARK {
+            int matches = 0;
+            for (AbstractResource *res : resources) {
+                for (Category *cat : categories) {
+                    matches += res->categoryMatches(cat);
+                }
+            }
+            QVERIFY(matches > 0);
+        }
+    }
+
+    void benchmarkUpdateModelSetResources()
+    {
+        AbstractResourcesBackend::Filters filter;
+        filter.state = AbstractResource::Upgradeable;
+        const auto upgradeable = fetchResources(m_appBackend->search(filter));
+        QVERIFY(!upgradeable.isEmpty());
+
+        const QList<AbstractResource *> all = upgradeable.toList();
+        const QList<AbstractResource *> half = all.mid(0, all.size() / 2);
+
+        UpdateModel model;
+        QBENCHMARK {
+            model.setResources(all);
+            model.setResources(half);
+        }
+    }
+
+    void benchmarkTransactionChurn_data()
+    {
+        QTest::addColumn<int>("count");
+        QTest::newRow("100") << 100;
+        QTest::newRow("1000") << 1000;
+    }
+
+    void benchmarkTransactionChurn()
+    {
+        QFETCH(int, count);
+        const auto resources = fetchResources(m_appBackend->search({})).mid(0, count);
+        QCOMPARE(resources.count(), count);
+
+        auto model = TransactionModel::global();
+        QBENCHMARK {
+            QVector<Transaction *> transactions;
+            transactions.reserve(count);
+            for (AbstractResource *res : resources) {
+                auto t = new BenchmarkTransaction(res);
+                model->addTransaction(t);
+                transactions += t;
+            }
+            for (int progress = 10; progress <= 100; progress += 10) {
+                for (Transaction *t : qAsConst(transactions)) {
+                    t->setProgress(progress);
+                }
+            }
+            for (Transaction *t : qAsConst(transactions)) {
+                t->setStatus(Transaction::DoneStatus);
+            }
+            QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        }
+        QCOMPARE(model->rowCount(), 0);
+    }
+
+    void benchmarkTransactionLookup()
+    {
+        const int count = 1000;
+        const auto resources = fetchResources(m_appBackend->search({})).mid(0, count);
+        QCOMPARE(resources.count(), count);
+
+        auto model = TransactionModel::global();
+        QVector<Transaction *> transactions;
+        for (AbstractResource *res : resources) {
+            auto t = new BenchmarkTransaction(res);
+            model->addTransaction(t);
+            transactions += t;
+        }
+
+        // What every visible delegate does to find its transaction
+        QBENCHMARK {
+            for (AbstractResource *res : resources) {
+                QVERIFY(model->indexOf(res).isValid());
+            }
+        }
+
+        for (Transaction *t : qAsConst(transactions)) {
+            t->setStatus(Transaction::DoneStatus);
+        }
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        QCOMPARE(model->rowCount(), 0);
+    }
+
+private:
+    ResourcesModel *m_model;
+    AbstractResourcesBackend *m_appBackend;
+};
+
+QTEST_MAIN(DummyBenchmark)
+
+#include "DummyBenchmark.moc"
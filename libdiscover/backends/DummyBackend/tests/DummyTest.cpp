@@ -12,12 +12,14 @@
 #include <QTest>
 #include <ReviewsBackend/ReviewsModel.h>
 #include <ScreenshotsModel.h>
+#include <Transaction/Transaction.h>
 #include <Transaction/TransactionModel.h>
 #include <UpdateModel/UpdateModel.h>
 #include <resources/AbstractBackendUpdater.h>
 #include <resources/ResourcesModel.h>
 #include <resources/ResourcesProxyModel.h>
 #include <resources/ResourcesUpdatesModel.h>
+#include <resources/StringInterner.h>
 
 #include <QtTest>
 
@@ -173,6 +175,34 @@ void DummyTest::testSort()
     }
 }
 
+void DummyTest::testResourcesChanged()
+{
+    ResourcesProxyModel pm;
+    new QAbstractItemModelTester(&pm, &pm);
+    QSignalSpy spyBusy(&pm, &ResourcesProxyModel::busyChanged);
+    pm.setFiltersFromCategory(CategoryModel::global()->rootCategories().first());
+    pm.componentComplete();
+    QVERIFY(spyBusy.wait());
+    QVERIFY(pm.rowCount() > 10);
+
+    QSignalSpy spyChanged(m_appBackend, &AbstractResourcesBackend::resourcesChanged);
+    QSignalSpy spyData(&pm, &QAbstractItemModel::dataChanged);
+    for (int i = 0; i < 10; ++i) {
+        m_appBackend->reportResourceChanged(pm.resourceAt(i), {"longDescription"});
+        m_appBackend->reportResourceChanged(pm.resourceAt(i), {"longDescription"});
+    }
+
+    // Reported together once the event loop gets to it, every resource once
+    QCOMPARE(spyChanged.count(), 0);
+    QVERIFY(spyChanged.wait());
+    QCOMPARE(spyChanged.count(), 1);
+    QCOMPARE(spyChanged.constFirst().constFirst().value<QVector<AbstractResource *>>().count(), 10);
+
+    QCOMPARE(spyData.count(), 1);
+    QCOMPARE(spyData.constFirst().at(0).toModelIndex().row(), 0);
+    QCOMPARE(spyData.constFirst().at(1).toModelIndex().row(), 9);
+}
+
 void DummyTest::testInstallAddons()
 {
     AbstractResourcesBackend::Filters filter;
@@ -213,6 +243,85 @@ void DummyTest::testInstallAddons()
     QVERIFY(!m.hasChanges());
 }
 
+QVector<AbstractResource *> DummyTest::installableResources(int count)
+{
+    const auto resources = fetchResources(m_appBackend->search({}));
+    QVector<AbstractResource *> ret;
+    for (auto res : resources) {
+        if (res->state() == AbstractResource::None && res->type() == AbstractResource::Application)
+            ret += res;
+        if (ret.count() == count)
+            break;
+    }
+    return ret;
+}
+
+static void installTogether(const QVector<AbstractResource *> &resources, QHash<AbstractResource *, Transaction::Status> *statuses)
+{
+    for (auto res : resources) {
+        auto t = res->backend()->installApplication(res);
+        QObject::connect(t, &Transaction::statusChanged, t, [statuses, res](Transaction::Status status) {
+            statuses->insert(res, status);
+        });
+        TransactionModel::global()->addTransaction(t);
+    }
+}
+
+void DummyTest::testInstallBatch()
+{
+    m_appBackend->setProperty("batchInstalls", true);
+    const auto resources = installableResources(3);
+    QCOMPARE(resources.count(), 3);
+    resources[1]->setProperty("failsToInstall", true);
+
+    QHash<AbstractResource *, Transaction::Status> statuses;
+    installTogether(resources, &statuses);
+    while (TransactionModel::global()->rowCount() > 0) {
+        QSignalSpy spy(TransactionModel::global(), &TransactionModel::transactionRemoved);
+        QVERIFY(spy.wait());
+    }
+
+    // Only the resource that failed reports an error, the others get installed
+    QCOMPARE(statuses.value(resources[0]), Transaction::DoneStatus);
+    QCOMPARE(statuses.value(resources[1]), Transaction::DoneWithErrorStatus);
+    QCOMPARE(statuses.value(resources[2]), Transaction::DoneStatus);
+    QCOMPARE(resources[0]->state(), AbstractResource::Installed);
+    QCOMPARE(resources[1]->state(), AbstractResource::None);
+    QCOMPARE(resources[2]->state(), AbstractResource::Installed);
+
+    resources[1]->setProperty("failsToInstall", false);
+    m_appBackend->setProperty("batchInstalls", false);
+}
+
+void DummyTest::testCancelBatchMember()
+{
+    m_appBackend->setProperty("batchInstalls", true);
+    const auto resources = installableResources(3);
+    QCOMPARE(resources.count(), 3);
+
+    QHash<AbstractResource *, Transaction::Status> statuses;
+    installTogether(resources, &statuses);
+    QSignalSpy progressSpy(TransactionModel::global(), &TransactionModel::progressChanged);
+    QVERIFY(progressSpy.wait());
+
+    // Cancelling the leader or a follower only takes that resource out
+    TransactionModel::global()->transactionFromResource(resources[0])->cancel();
+    TransactionModel::global()->transactionFromResource(resources[2])->cancel();
+    while (TransactionModel::global()->rowCount() > 0) {
+        QSignalSpy spy(TransactionModel::global(), &TransactionModel::transactionRemoved);
+        QVERIFY(spy.wait());
+    }
+
+    QCOMPARE(statuses.value(resources[0]), Transaction::CancelledStatus);
+    QCOMPARE(statuses.value(resources[1]), Transaction::DoneStatus);
+    QCOMPARE(statuses.value(resources[2]), Transaction::CancelledStatus);
+    QCOMPARE(resources[0]->state(), AbstractResource::None);
+    QCOMPARE(resources[1]->state(), AbstractResource::Installed);
+    QCOMPARE(resources[2]->state(), AbstractResource::None);
+
+    m_appBackend->setProperty("batchInstalls", false);
+}
+
 void DummyTest::testReviewsModel()
 {
     AbstractResourcesBackend::Filters filter;
@@ -284,3 +393,23 @@ void DummyTest::testScreenshotsModel()
 }
 
 // TODO test cancel transaction
+
+void DummyTest::testMetadata()
+{
+    const auto resources = fetchResources(m_appBackend->search({}));
+    QVERIFY(!resources.isEmpty());
+
+    AbstractResource *res = resources.constFirst();
+    QVERIFY(res->getMetadata(QStringLiteral("dummy::key")).isUndefined());
+    res->addMetadata(QStringLiteral("dummy::key"), 1);
+    res->addMetadata(QStringLiteral("dummy::key"), QStringLiteral("value"));
+    QCOMPARE(res->getMetadata(QStringLiteral("dummy::key")).toString(), QStringLiteral("value"));
+
+    const QString a = QStringLiteral("origin-") + QString::number(42);
+    const QString b = QStringLiteral("origin-") + QString::number(42);
+    QVERIFY(a.constData() != b.constData());
+    QCOMPARE(StringInterner::intern(a).constData(), StringInterner::intern(b).constData());
+
+    QVERIFY(res->memoryFootprint() > 0);
+    QVERIFY(m_model->memoryReport().contains(m_appBackend->name()));
+}
@@ -8,8 +8,10 @@
 #define DUMMYTEST_H
 
 #include <QObject>
+#include <QVector>
 
 class ResourcesModel;
+class AbstractResource;
 class AbstractResourcesBackend;
 
 class DummyTest : public QObject
@@ -26,12 +28,18 @@ private Q_SLOTS:
     void testProxySorting();
     void testFetch();
     void testSort();
+    void testResourcesChanged();
     void testInstallAddons();
+    void testInstallBatch();
+    void testCancelBatchMember();
     void testReviewsModel();
     void testUpdateModel();
     void testScreenshotsModel();
+    void testMetadata();
 
 private:
+    QVector<AbstractResource *> installableResources(int count);
+
     AbstractResourcesBackend *m_appBackend;
     ResourcesModel *m_model;
 };
@@ -10,8 +10,10 @@
 #include <QAbstractItemModelTester>
 #include <ReviewsBackend/ReviewsModel.h>
 #include <Transaction/TransactionModel.h>
+#include <UpdateModel/UpdateItem.h>
 #include <UpdateModel/UpdateModel.h>
 #include <resources/AbstractBackendUpdater.h>
+#include <resources/AbstractResourcesBackend.h>
 #include <resources/ResourcesModel.h>
 #include <resources/ResourcesProxyModel.h>
 #include <resources/ResourcesUpdatesModel.h>
@@ -75,6 +77,51 @@ private Q_SLOTS:
         delete m;
     }
 
+    void testIncrementalResources()
+    {
+        AbstractResourcesBackend::Filters filter;
+        filter.state = AbstractResource::Upgradeable;
+        QList<AbstractResource *> resources;
+        auto stream = m_appBackend->search(filter);
+        connect(stream, &ResultsStream::resourcesFound, this, [&resources](const QVector<AbstractResource *> &found) {
+            resources += found.toList();
+        });
+        QSignalSpy spyStream(stream, &ResultsStream::destroyed);
+        QVERIFY(spyStream.wait());
+        QVERIFY(resources.count() > 2);
+
+        UpdateModel *m = new UpdateModel(this);
+        new QAbstractItemModelTester(m, m);
+        m->setResources(resources);
+        QCOMPARE(m->rowCount(), resources.count());
+
+        const QModelIndex kept = m->index(m->rowCount() - 1, 0);
+        m->itemFromIndex(kept)->setChangelog(QStringLiteral("keep me"));
+        auto keptResource = kept.data(UpdateModel::ResourceRole).value<QObject *>();
+
+        QSignalSpy spyReset(m, &QAbstractItemModel::modelReset);
+        QSignalSpy spyRemoved(m, &QAbstractItemModel::rowsRemoved);
+        QSignalSpy spyInserted(m, &QAbstractItemModel::rowsInserted);
+        const auto first = m->index(0, 0).data(UpdateModel::ResourceRole).value<QObject *>();
+        resources.removeAll(qobject_cast<AbstractResource *>(first));
+        m->setResources(resources);
+        QCOMPARE(m->rowCount(), resources.count());
+        QCOMPARE(spyRemoved.count(), 1);
+        QCOMPARE(spyInserted.count(), 0);
+
+        resources.prepend(qobject_cast<AbstractResource *>(first));
+        m->setResources(resources);
+        QCOMPARE(m->rowCount(), resources.count());
+        QCOMPARE(spyInserted.count(), 1);
+        QCOMPARE(m->index(0, 0).data(UpdateModel::ResourceRole).value<QObject *>(), first);
+        QCOMPARE(spyReset.count(), 0);
+
+        const QModelIndex keptAfter = m->index(m->rowCount() - 1, 0);
+        QCOMPARE(keptAfter.data(UpdateModel::ResourceRole).value<QObject *>(), keptResource);
+        QCOMPARE(keptAfter.data(UpdateModel::ChangelogRole).toString(), QStringLiteral("keep me"));
+        delete m;
+    }
+
     void testUpdate()
     {
         ResourcesUpdatesModel *rum = new ResourcesUpdatesModel(this);
@@ -9,7 +9,9 @@
 #include "FlatpakFetchDataJob.h"
 #include "FlatpakJobTransaction.h"
 #include "FlatpakSourcesBackend.h"
+#include "FlatpakUpdatesCache.h"
 
+#include <DiscoverBackendsFactory.h>
 #include <ReviewsBackend/Rating.h>
 #include <Transaction/Transaction.h>
 #include <appstream/AppStreamIntegration.h>
@@ -76,7 +78,7 @@ static FlatpakResource::Id idForInstalledRef(FlatpakInstallation *installation,
 FlatpakBackend::FlatpakBackend(QObject *parent)
     : AbstractResourcesBackend(parent)
     , m_updater(new StandardBackendUpdater(this))
-    , m_reviews(AppStreamIntegration::global()->reviews())
+    , m_reviews(DiscoverBackendsFactory::isUpdatesOnly() ? QSharedPointer<OdrsReviewsBackend>() : AppStreamIntegration::global()->reviews())
     , m_refreshAppstreamMetadataJobs(0)
     , m_cancellable(g_cancellable_new())
     , m_threadPool(new QThreadPool(this))
@@ -89,17 +91,25 @@ FlatpakBackend::FlatpakBackend(QObject *parent)
     if (!setupFlatpakInstallations(&error)) {
         qWarning() << "Failed to setup flatpak installations:" << error->message;
     } else {
-        loadAppsFromAppstreamData();
+        if (DiscoverBackendsFactory::isUpdatesOnly()) {
+            // Only installed refs can be updated, no need to load the remotes' catalog
+            loadInstalledApps();
+            loadUpdates(true);
+        } else {
+            loadAppsFromAppstreamData();
+        }
 
         m_sources = new FlatpakSourcesBackend(m_installations, this);
         SourcesModel::global()->addSourcesBackend(m_sources);
     }
 
-    connect(m_reviews.data(), &OdrsReviewsBackend::ratingsReady, this, [this] {
-        m_reviews->emitRatingFetched(this, kTransform<QList<AbstractResource *>>(m_resources, [](AbstractResource *r) {
-                                         return r;
-                                     }));
-    });
+    if (m_reviews) {
+        connect(m_reviews.data(), &OdrsReviewsBackend::ratingsReady, this, [this] {
+            m_reviews->emitRatingFetched(this, kTransform<QList<AbstractResource *>>(m_resources, [](AbstractResource *r) {
+                                             return r;
+                                         }));
+        });
+    }
 
     /* Override the umask to 022 to make it possible to share files between
      * the plasma-discover process and flatpak system helper process.
@@ -556,7 +566,7 @@ void FlatpakBackend::addResource(FlatpakResource *resource)
 
     connect(resource, &FlatpakResource::sizeChanged, this, [this, resource] {
         if (!isFetching())
-            Q_EMIT resourcesChanged(resource, {"size", "sizeDescription"});
+            reportResourceChanged(resource, {"size", "sizeDescription"});
     });
 }
 
@@ -638,7 +648,7 @@ void FlatpakBackend::metadataRefreshed()
     m_refreshAppstreamMetadataJobs--;
     if (m_refreshAppstreamMetadataJobs == 0) {
         loadInstalledApps();
-        checkForUpdates();
+        loadUpdates(true);
     }
 }
 
@@ -803,7 +813,7 @@ void FlatpakBackend::loadLocalUpdates(FlatpakInstallation *flatpakInstallation)
     }
 }
 
-void FlatpakBackend::loadRemoteUpdates(FlatpakInstallation *installation)
+void FlatpakBackend::loadRemoteUpdates(FlatpakInstallation *installation, bool allowCached)
 {
     auto fw = new QFutureWatcher<GPtrArray *>(this);
     connect(fw, &QFutureWatcher<GPtrArray *>::finished, this, [this, installation, fw]() {
@@ -813,13 +823,13 @@ void FlatpakBackend::loadRemoteUpdates(FlatpakInstallation *installation)
         acquireFetching(false);
     });
     acquireFetching(true);
-    fw->setFuture(QtConcurrent::run(&m_threadPool, [installation, this]() -> GPtrArray * {
+    fw->setFuture(QtConcurrent::run(&m_threadPool, [installation, allowCached, this]() -> GPtrArray * {
         g_autoptr(GError) localError = nullptr;
         if (g_cancellable_is_cancelled(m_cancellable)) {
             qWarning() << "don't issue commands after cancelling";
             return {};
         }
-        GPtrArray *refs = flatpak_installation_list_installed_refs_for_update(installation, m_cancellable, &localError);
+        GPtrArray *refs = flatpakInstalledRefsForUpdate(installation, m_cancellable, &localError, allowCached);
         if (!refs) {
             qWarning() << "Failed to get list of installed refs for listing updates: " << localError->message;
         }
@@ -1272,6 +1282,56 @@ QVector<AbstractResource *> FlatpakBackend::resourcesByAppstreamName(const QStri
     return resources;
 }
 
+ResultsStream *FlatpakBackend::findResourcesByUrls(const QVector<QUrl> &urls)
+{
+    const bool allAppstream = std::all_of(urls.constBegin(), urls.constEnd(), [](const QUrl &url) {
+        return url.scheme() == QLatin1String("appstream");
+    });
+    if (!allAppstream)
+        return AbstractResourcesBackend::findResourcesByUrls(urls);
+
+    auto stream = new ResultsStream(QStringLiteral("FlatpakStream-urls"));
+    auto f = [this, stream, urls]() {
+        // Index every resource by its ids once, resourcesByAppstreamName would walk them all per url
+        QHash<QString, QVector<AbstractResource *>> index;
+        for (FlatpakResource *res : qAsConst(m_resources)) {
+            index[AppStreamUtils::normalizedAppstreamId(res->appstreamId())] += res;
+            const auto alts = res->alternativeAppstreamIds();
+            for (const auto &alt : alts) {
+                index[AppStreamUtils::normalizedAppstreamId(alt)] += res;
+            }
+        }
+
+        auto lessThan = [this](AbstractResource *l, AbstractResource *r) {
+            return flatpakResourceLessThan(l, r);
+        };
+        QVector<AbstractResource *> resources;
+        for (const QUrl &url : urls) {
+            const auto appstreamIds = AppStreamUtils::appstreamIds(url);
+            for (const QString &appstreamId : appstreamIds) {
+                if (appstreamId.isEmpty())
+                    continue;
+                auto found = index.value(AppStreamUtils::normalizedAppstreamId(appstreamId));
+                std::sort(found.begin(), found.end(), lessThan);
+                for (auto res : qAsConst(found)) {
+                    if (!resources.contains(res))
+                        resources += res;
+                }
+            }
+        }
+        if (!resources.isEmpty())
+            Q_EMIT stream->resourcesFound(resources);
+        stream->finish();
+    };
+
+    if (isFetching()) {
+        connect(this, &FlatpakBackend::initialized, stream, f);
+    } else {
+        QTimer::singleShot(0, this, f);
+    }
+    return stream;
+}
+
 ResultsStream *FlatpakBackend::findResourceByPackageName(const QUrl &url)
 {
     if (url.scheme() == QLatin1String("appstream")) {
@@ -1330,15 +1390,46 @@ Transaction *FlatpakBackend::installApplication(AbstractResource *app, const Add
         return nullptr;
     }
 
-    FlatpakJobTransaction *transaction = new FlatpakJobTransaction(resource, Transaction::InstallRole);
+    // Updates are usually requested all at once, see flushUpdateQueue()
+    const bool isUpdate = resource->state() == AbstractResource::Upgradeable && resource->isInstalled();
+    FlatpakJobTransaction *transaction = new FlatpakJobTransaction(resource, Transaction::InstallRole, isUpdate);
     connect(transaction, &FlatpakJobTransaction::statusChanged, this, [this, resource](Transaction::Status status) {
         if (status == Transaction::Status::DoneStatus) {
             updateAppState(resource);
         }
     });
+    if (isUpdate) {
+        if (m_updateQueue.isEmpty()) {
+            QTimer::singleShot(0, this, &FlatpakBackend::flushUpdateQueue);
+        }
+        m_updateQueue += transaction;
+    }
     return transaction;
 }
 
+void FlatpakBackend::flushUpdateQueue()
+{
+    // One transaction per installation, so what the updates share is only pulled once
+    QVector<FlatpakInstallation *> installations;
+    QHash<FlatpakInstallation *, QVector<FlatpakJobTransaction *>> batches;
+    for (const auto &transaction : qExchange(m_updateQueue, {})) {
+        if (!transaction || transaction->status() != Transaction::QueuedStatus)
+            continue;
+
+        auto installation = qobject_cast<FlatpakResource *>(transaction->resource())->installation();
+        auto &batch = batches[installation];
+        if (batch.isEmpty())
+            installations += installation;
+        batch += transaction;
+    }
+
+    for (auto installation : qAsConst(installations)) {
+        auto batch = batches.take(installation);
+        auto leader = batch.takeFirst();
+        leader->startBatch(batch);
+    }
+}
+
 Transaction *FlatpakBackend::installApplication(AbstractResource *app)
 {
     return installApplication(app, {});
@@ -1367,6 +1458,12 @@ Transaction *FlatpakBackend::removeApplication(AbstractResource *app)
 }
 
 void FlatpakBackend::checkForUpdates()
+{
+    // Asked for explicitly, don't settle for what was found a while ago
+    loadUpdates(false);
+}
+
+void FlatpakBackend::loadUpdates(bool allowCached)
 {
     for (auto installation : qAsConst(m_installations)) {
         // Load local updates, comparing current and latest commit
@@ -1376,7 +1473,7 @@ void FlatpakBackend::checkForUpdates()
             break;
 
         // Load updates from remote repositories
-        loadRemoteUpdates(installation);
+        loadRemoteUpdates(installation, allowCached);
 
         if (g_cancellable_is_cancelled(m_cancellable))
             break;
@@ -10,6 +10,7 @@
 
 #include "FlatpakResource.h"
 
+#include <QPointer>
 #include <QSharedPointer>
 #include <QThreadPool>
 #include <QVariantList>
@@ -19,6 +20,7 @@
 
 #include "flatpak-helper.h"
 
+class FlatpakJobTransaction;
 class FlatpakSourcesBackend;
 class StandardBackendUpdater;
 class OdrsReviewsBackend;
@@ -34,6 +36,7 @@ public:
     AbstractReviewsBackend *reviewsBackend() const override;
     ResultsStream *search(const AbstractResourcesBackend::Filters &search) override;
     ResultsStream *findResourceByPackageName(const QUrl &search);
+    ResultsStream *findResourcesByUrls(const QVector<QUrl> &urls) override;
     QList<FlatpakResource *> resources() const
     {
         return m_resources.values();
@@ -97,7 +100,8 @@ private:
     void loadInstalledApps();
     bool loadInstalledApps(FlatpakInstallation *flatpakInstallation);
     void loadLocalUpdates(FlatpakInstallation *flatpakInstallation);
-    void loadRemoteUpdates(FlatpakInstallation *flatpakInstallation);
+    void loadRemoteUpdates(FlatpakInstallation *flatpakInstallation, bool allowCached);
+    void loadUpdates(bool allowCached);
     bool parseMetadataFromAppBundle(FlatpakResource *resource);
     void refreshAppstreamMetadata(FlatpakInstallation *installation, FlatpakRemote *remote);
     bool setupFlatpakInstallations(GError **error);
@@ -107,6 +111,7 @@ private:
     bool updateAppMetadata(FlatpakResource *resource, const QString &path);
     bool updateAppSizeFromRemote(FlatpakResource *resource);
     void updateAppState(FlatpakResource *resource);
+    void flushUpdateQueue();
 
     QVector<AbstractResource *> resourcesByAppstreamName(const QString &name) const;
     void acquireFetching(bool f);
@@ -122,6 +127,7 @@ private:
     GCancellable *m_cancellable;
     QVector<FlatpakInstallation *> m_installations;
     QThreadPool m_threadPool;
+    QVector<QPointer<FlatpakJobTransaction>> m_updateQueue;
 };
 
 #endif // FLATPAKBACKEND_H
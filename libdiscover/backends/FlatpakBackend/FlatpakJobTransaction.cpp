@@ -29,27 +29,128 @@ FlatpakJobTransaction::~FlatpakJobTransaction() = default;
 
 void FlatpakJobTransaction::cancel()
 {
-    m_appJob->cancel();
+    if (m_leader) {
+        // Our operation is part of the leader's transaction
+        m_leader->cancel();
+        return;
+    }
+
+    if (m_appJob)
+        m_appJob->cancel();
     setStatus(CancelledStatus);
+    for (const auto &follower : qAsConst(m_followers)) {
+        if (follower)
+            follower->setStatus(CancelledStatus);
+    }
+}
+
+void FlatpakJobTransaction::startBatch(const QVector<FlatpakJobTransaction *> &followers)
+{
+    for (FlatpakJobTransaction *follower : followers) {
+        Q_ASSERT(follower->m_app->installation() == m_app->installation());
+        follower->m_leader = this;
+        m_followers += follower;
+    }
+    start();
 }
 
 void FlatpakJobTransaction::start()
 {
     setStatus(CommittingStatus);
 
+    QVector<FlatpakResource *> apps = {m_app};
+    for (const auto &follower : qAsConst(m_followers)) {
+        if (follower && follower->m_app) {
+            follower->setStatus(CommittingStatus);
+            apps += follower->m_app;
+        }
+    }
+
     // App job will be added every time
-    m_appJob = new FlatpakTransactionThread(m_app, role());
+    m_appJob = new FlatpakTransactionThread(apps, role());
     connect(m_appJob, &FlatpakTransactionThread::finished, this, &FlatpakJobTransaction::finishTransaction);
-    connect(m_appJob, &FlatpakTransactionThread::progressChanged, this, &FlatpakJobTransaction::setProgress);
-    connect(m_appJob, &FlatpakTransactionThread::speedChanged, this, &FlatpakJobTransaction::setDownloadSpeed);
+    connect(m_appJob, &FlatpakTransactionThread::progressChanged, this, &FlatpakJobTransaction::updateProgress);
+    connect(m_appJob, &FlatpakTransactionThread::operationProgressChanged, this, &FlatpakJobTransaction::updateOperationProgress);
+    connect(m_appJob, &FlatpakTransactionThread::speedChanged, this, &FlatpakJobTransaction::updateSpeed);
+    connect(m_appJob, &FlatpakTransactionThread::remainingTimeChanged, this, &FlatpakJobTransaction::updateRemainingTime);
     connect(m_appJob, &FlatpakTransactionThread::passiveMessage, this, &FlatpakJobTransaction::passiveMessage);
 
     m_appJob->start();
 }
 
+void FlatpakJobTransaction::updateProgress(int progress)
+{
+    // The ones that get progress for their own operation show that instead
+    if (!m_operationProgress.contains(this))
+        setProgress(progress);
+    for (const auto &follower : qAsConst(m_followers)) {
+        if (follower && !m_operationProgress.contains(follower))
+            follower->setProgress(progress);
+    }
+}
+
+void FlatpakJobTransaction::updateSpeed(quint64 speed)
+{
+    // They all wait on the same downloads
+    setDownloadSpeed(speed);
+    for (const auto &follower : qAsConst(m_followers)) {
+        if (follower)
+            follower->setDownloadSpeed(speed);
+    }
+}
+
+void FlatpakJobTransaction::updateRemainingTime(uint seconds)
+{
+    setRemainingTime(seconds);
+    for (const auto &follower : qAsConst(m_followers)) {
+        if (follower)
+            follower->setRemainingTime(seconds);
+    }
+}
+
+void FlatpakJobTransaction::updateOperationProgress(const QString &ref, int progress)
+{
+    FlatpakJobTransaction *owner = nullptr;
+    if (m_app && m_app->ref() == ref) {
+        owner = this;
+    } else {
+        for (const auto &follower : qAsConst(m_followers)) {
+            if (follower && follower->m_app && follower->m_app->ref() == ref) {
+                owner = follower;
+                break;
+            }
+        }
+    }
+
+    // Runtimes and extensions pulled in as dependencies don't belong to anyone
+    if (owner) {
+        m_operationProgress.insert(owner);
+        owner->setProgress(progress);
+    }
+}
+
 void FlatpakJobTransaction::finishTransaction()
 {
-    if (m_appJob->result()) {
+    bool failed = false;
+    for (const auto &follower : qAsConst(m_followers)) {
+        if (follower && follower->m_app) {
+            const bool success = m_appJob->result(follower->m_app->ref());
+            follower->finishOperation(success);
+            failed |= !success;
+        }
+    }
+    const bool success = m_app && m_appJob->result(m_app->ref());
+    failed |= !success;
+
+    if (failed && !m_appJob->errorMessage().isEmpty()) {
+        Q_EMIT passiveMessage(m_appJob->errorMessage());
+    }
+    finishOperation(success);
+}
+
+void FlatpakJobTransaction::finishOperation(bool success)
+{
+    if (success) {
         AbstractResource::State newState = AbstractResource::None;
         switch (role()) {
         case InstallRole:
@@ -65,9 +166,6 @@ void FlatpakJobTransaction::finishTransaction()
 
         setStatus(DoneStatus);
     } else {
-        if (!m_appJob->errorMessage().isEmpty()) {
-            Q_EMIT passiveMessage(m_appJob->errorMessage());
-        }
         setStatus(DoneWithErrorStatus);
     }
 }
@@ -9,6 +9,8 @@
 #define FLATPAKJOBTRANSACTION_H
 
 #include <QPointer>
+#include <QSet>
+#include <QVector>
 #include <Transaction/Transaction.h>
 #include "flatpak-helper.h"
 
@@ -27,15 +29,30 @@ public:
 
     void cancel() override;
 
+    /**
+     * Runs the operations of @p followers along with ours in a single flatpak transaction, so
+     * the runtimes and extensions they share are only resolved and pulled once.
+     *
+     * They need to be in the same installation and be delayed.
+     */
+    void startBatch(const QVector<FlatpakJobTransaction *> &followers);
+
 public Q_SLOTS:
     void finishTransaction();
     void start();
 
 private:
-    void updateProgress();
+    void finishOperation(bool success);
+    void updateProgress(int progress);
+    void updateSpeed(quint64 speed);
+    void updateRemainingTime(uint seconds);
+    void updateOperationProgress(const QString &ref, int progress);
 
     QPointer<FlatpakResource> m_app;
     QPointer<FlatpakTransactionThread> m_appJob;
+    QPointer<FlatpakJobTransaction> m_leader;
+    QVector<QPointer<FlatpakJobTransaction>> m_followers;
+    QSet<FlatpakJobTransaction *> m_operationProgress;
 };
 
 #endif // FLATPAKJOBTRANSACTION_H
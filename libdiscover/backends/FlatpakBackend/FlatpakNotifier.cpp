@@ -6,13 +6,101 @@
  */
 
 #include "FlatpakNotifier.h"
+#include "FlatpakUpdatesCache.h"
+#include "libdiscover_backend_debug.h"
 
 #include <glib.h>
 
+#include <QDateTime>
 #include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
 #include <QFutureWatcher>
+#include <QHash>
+#include <QRandomGenerator>
 #include <QTimer>
 #include <QtConcurrentRun>
+#include <algorithm>
+#include <limits>
+
+/// Summaries fetched more recently than this (in seconds) are good enough to tell whether there are updates
+static const qint64 s_summariesMaxAge = 60 * 60;
+/// How often to make sure we're not missing updates because nobody refreshed the summaries, in msecs
+static const qint64 s_remoteCheckInterval = 24 * 60 * 60 * 1000;
+/// First retry after a remote check failed, doubled on every further failure, in msecs
+static const qint64 s_remoteRetryInterval = 15 * 60 * 1000;
+
+struct UpdatesCheck {
+    GPtrArray *refs = nullptr;
+    bool remote = false;
+    qint64 elapsed = 0;
+};
+
+static QString installationPath(FlatpakInstallation *installation)
+{
+    g_autoptr(GFile) file = flatpak_installation_get_path(installation);
+    g_autofree char *path = g_file_get_path(file);
+    return QString::fromUtf8(path);
+}
+
+/// @returns the seconds since flatpak last fetched the summaries of the remotes, no matter who asked for it
+static qint64 summariesAge(FlatpakInstallation *installation)
+{
+    const QString root = installationPath(installation);
+
+    QDateTime newest;
+    const auto consider = [&newest](const QFileInfo &info) {
+        if (info.exists() && (!newest.isValid() || info.lastModified() > newest))
+            newest = info.lastModified();
+    };
+    const QDir summaries(root + QLatin1String("/repo/tmp/cache/summaries"));
+    const auto summaryFiles = summaries.entryInfoList(QDir::Files);
+    for (const QFileInfo &info : summaryFiles)
+        consider(info);
+
+    // Refreshing the appstream metadata, as Discover does when it starts, fetches the summaries as well
+    const QDir appstream(root + QLatin1String("/appstream"));
+    const auto remotes = appstream.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &remote : remotes) {
+        const QDir remoteDir(appstream.filePath(remote));
+        const auto arches = remoteDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QString &arch : arches)
+            consider(QFileInfo(remoteDir.filePath(arch) + QLatin1String("/.timestamp")));
+    }
+    return newest.isValid() ? newest.secsTo(QDateTime::currentDateTime()) : std::numeric_limits<qint64>::max();
+}
+
+/// Same as flatpak_installation_list_installed_refs_for_update() without touching the network, based on the summaries flatpak cached
+static GPtrArray *listCachedUpdates(FlatpakInstallation *installation, GCancellable *cancellable, GError **error)
+{
+    g_autoptr(GPtrArray) installed = flatpak_installation_list_installed_refs(installation, cancellable, error);
+    if (!installed)
+        return nullptr;
+
+    QHash<QByteArray, QHash<QByteArray, QByteArray>> commitsByRemote;
+    GPtrArray *ret = g_ptr_array_new_with_free_func(g_object_unref);
+    for (uint i = 0; i < installed->len; i++) {
+        FlatpakInstalledRef *ref = FLATPAK_INSTALLED_REF(g_ptr_array_index(installed, i));
+        const QByteArray origin = flatpak_installed_ref_get_origin(ref);
+        auto it = commitsByRemote.find(origin);
+        if (it == commitsByRemote.end()) {
+            it = commitsByRemote.insert(origin, {});
+            g_autoptr(GPtrArray) remoteRefs =
+                flatpak_installation_list_remote_refs_sync_full(installation, origin.constData(), FLATPAK_QUERY_FLAGS_ONLY_CACHED, cancellable, nullptr);
+            for (uint j = 0; remoteRefs && j < remoteRefs->len; j++) {
+                FlatpakRef *remoteRef = FLATPAK_REF(g_ptr_array_index(remoteRefs, j));
+                g_autofree char *id = flatpak_ref_format_ref(remoteRef);
+                it->insert(id, flatpak_ref_get_commit(remoteRef));
+            }
+        }
+
+        g_autofree char *id = flatpak_ref_format_ref(FLATPAK_REF(ref));
+        const QByteArray latestCommit = it->value(id);
+        if (!latestCommit.isEmpty() && latestCommit != flatpak_ref_get_commit(FLATPAK_REF(ref)))
+            g_ptr_array_add(ret, g_object_ref(ref));
+    }
+    return ret;
+}
 
 static void installationChanged(GFileMonitor *monitor, GFile *child, GFile *other_file, GFileMonitorEvent event_type, gpointer self)
 {
@@ -25,8 +113,9 @@ static void installationChanged(GFileMonitor *monitor, GFile *child, GFile *othe
     if (!installation)
         return;
 
+    // Deploys change the installed commits, what we know about the remotes is still valid
     FlatpakNotifier *notifier = installation->m_notifier;
-    notifier->loadRemoteUpdates(installation);
+    notifier->loadLocalUpdates(installation);
 }
 
 FlatpakNotifier::FlatpakNotifier(QObject *parent)
@@ -34,10 +123,14 @@ FlatpakNotifier::FlatpakNotifier(QObject *parent)
     , m_user(this)
     , m_system(this)
     , m_cancellable(g_cancellable_new())
+    , m_remoteCheckTimer(new QTimer(this))
 {
-    QTimer *dailyCheck = new QTimer(this);
-    dailyCheck->setInterval(24 * 60 * 60 * 1000); // refresh at least once every day
-    connect(dailyCheck, &QTimer::timeout, this, &FlatpakNotifier::recheckSystemUpdateNeeded);
+    m_remoteCheckTimer->setSingleShot(true);
+    connect(m_remoteCheckTimer, &QTimer::timeout, this, [this] {
+        checkUpdates(true);
+        if (m_pendingRemoteChecks == 0)
+            scheduleRemoteCheck();
+    });
 }
 
 FlatpakNotifier::Installation::Installation(FlatpakNotifier *notifier)
@@ -66,12 +159,44 @@ void FlatpakNotifier::recheckSystemUpdateNeeded()
     if (!setupFlatpakInstallations(&error)) {
         qWarning() << "Failed to setup flatpak installations: " << error->message;
     } else {
-        // Load updates from remote repositories
-        loadRemoteUpdates(&m_system);
-        loadRemoteUpdates(&m_user);
+        // While backing off, only the timer goes to the network
+        checkUpdates(m_remoteFailures == 0);
+        if (!m_remoteCheckTimer->isActive() && m_pendingRemoteChecks == 0)
+            scheduleRemoteCheck();
+    }
+}
+
+void FlatpakNotifier::checkUpdates(bool allowRemote)
+{
+    for (Installation *installation : {&m_system, &m_user}) {
+        if (allowRemote && summariesAge(installation->m_installation) > s_summariesMaxAge)
+            loadRemoteUpdates(installation);
+        else
+            loadLocalUpdates(installation);
     }
 }
 
+void FlatpakNotifier::scheduleRemoteCheck()
+{
+    qint64 delay = s_remoteCheckInterval;
+    if (m_remoteFailures > 0)
+        delay = std::min(s_remoteRetryInterval << std::min(m_remoteFailures - 1, 10), s_remoteCheckInterval);
+    // Don't have every system that booted at the same time hit the remotes together
+    delay += QRandomGenerator::global()->bounded(quint32(delay / 10));
+    m_remoteCheckTimer->start(int(delay));
+}
+
+void FlatpakNotifier::remoteCheckFinished(bool success)
+{
+    m_remoteCheckFailed |= !success;
+    if (--m_pendingRemoteChecks > 0)
+        return;
+
+    m_remoteFailures = m_remoteCheckFailed ? m_remoteFailures + 1 : 0;
+    m_remoteCheckFailed = false;
+    scheduleRemoteCheck();
+}
+
 void FlatpakNotifier::onFetchUpdatesFinished(Installation *installation, GPtrArray *updates)
 {
     bool hasUpdates = false;
@@ -97,23 +222,63 @@ void FlatpakNotifier::onFetchUpdatesFinished(Installation *installation, GPtrArr
     }
 }
 
+static void logCheck(FlatpakInstallation *installation, const UpdatesCheck &check)
+{
+    qCDebug(LIBDISCOVER_BACKEND_LOG) << "checked" << flatpak_installation_get_id(installation)
+                                     << (check.remote ? "on the remotes" : "against the cached summaries") << "in" << check.elapsed
+                                     << "ms, updates:" << (check.refs ? int(check.refs->len) : -1);
+}
+
+void FlatpakNotifier::loadLocalUpdates(Installation *installation)
+{
+    auto fw = new QFutureWatcher<UpdatesCheck>(this);
+    connect(fw, &QFutureWatcher<UpdatesCheck>::finished, this, [this, installation, fw]() {
+        const UpdatesCheck check = fw->result();
+        logCheck(installation->m_installation, check);
+        if (check.refs)
+            onFetchUpdatesFinished(installation, check.refs);
+        fw->deleteLater();
+    });
+    fw->setFuture(QtConcurrent::run([installation]() -> UpdatesCheck {
+        QElapsedTimer timer;
+        timer.start();
+        g_autoptr(GCancellable) cancellable = g_cancellable_new();
+        g_autoptr(GError) localError = nullptr;
+        UpdatesCheck ret;
+        ret.refs = listCachedUpdates(installation->m_installation, cancellable, &localError);
+        if (!ret.refs) {
+            qWarning() << "Failed to get list of installed refs for listing updates: " << localError->message;
+        }
+        ret.elapsed = timer.elapsed();
+        return ret;
+    }));
+}
+
 void FlatpakNotifier::loadRemoteUpdates(Installation *installation)
 {
-    auto fw = new QFutureWatcher<GPtrArray *>(this);
-    connect(fw, &QFutureWatcher<GPtrArray *>::finished, this, [this, installation, fw]() {
-        g_autoptr(GPtrArray) refs = fw->result();
-        if (refs)
-            onFetchUpdatesFinished(installation, refs);
+    ++m_pendingRemoteChecks;
+    auto fw = new QFutureWatcher<UpdatesCheck>(this);
+    connect(fw, &QFutureWatcher<UpdatesCheck>::finished, this, [this, installation, fw]() {
+        const UpdatesCheck check = fw->result();
+        logCheck(installation->m_installation, check);
+        if (check.refs)
+            onFetchUpdatesFinished(installation, check.refs);
+        remoteCheckFinished(check.refs != nullptr);
         fw->deleteLater();
     });
-    fw->setFuture(QtConcurrent::run([installation]() -> GPtrArray * {
+    fw->setFuture(QtConcurrent::run([installation]() -> UpdatesCheck {
+        QElapsedTimer timer;
+        timer.start();
         g_autoptr(GCancellable) cancellable = g_cancellable_new();
         g_autoptr(GError) localError = nullptr;
-        GPtrArray *refs = flatpak_installation_list_installed_refs_for_update(installation->m_installation, cancellable, &localError);
-        if (!refs) {
+        UpdatesCheck ret;
+        ret.remote = true;
+        ret.refs = flatpakInstalledRefsForUpdate(installation->m_installation, cancellable, &localError);
+        if (!ret.refs) {
             qWarning() << "Failed to get list of installed refs for listing updates: " << localError->message;
         }
-        return refs;
+        ret.elapsed = timer.elapsed();
+        return ret;
     }));
 }
 
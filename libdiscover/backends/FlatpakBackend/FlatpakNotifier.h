@@ -10,6 +10,8 @@
 #include <BackendNotifierModule.h>
 #include <functional>
 
+class QTimer;
+
 #include "flatpak-helper.h"
 
 class FlatpakNotifier : public BackendNotifierModule
@@ -45,11 +47,20 @@ public:
     };
 
     void onFetchUpdatesFinished(Installation *flatpakInstallation, GPtrArray *updates);
+    void loadLocalUpdates(Installation *installation);
     void loadRemoteUpdates(Installation *installation);
     bool setupFlatpakInstallations(GError **error);
+    void checkUpdates(bool allowRemote);
+    void remoteCheckFinished(bool success);
+    void scheduleRemoteCheck();
     Installation m_user;
     Installation m_system;
     GCancellable *const m_cancellable;
+    QTimer *const m_remoteCheckTimer;
+    /// Remote checks that failed in a row, we back off while it's not 0
+    int m_remoteFailures = 0;
+    int m_pendingRemoteChecks = 0;
+    bool m_remoteCheckFailed = false;
 };
 
 #endif
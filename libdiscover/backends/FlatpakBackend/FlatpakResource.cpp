@@ -15,6 +15,8 @@
 #include <AppStreamQt/icon.h>
 #include <AppStreamQt/screenshot.h>
 #include <appstream/AppStreamUtils.h>
+#include <resources/IconLoader.h>
+#include <resources/StringInterner.h>
 
 #include <KFormat>
 #include <KLocalizedString>
@@ -22,61 +24,22 @@
 #include <AppStreamQt/release.h>
 #include <QDebug>
 #include <QDesktopServices>
-#include <QDir>
 #include <QFileInfo>
 #include <QIcon>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
-#include <QNetworkRequest>
 #include <QProcess>
 #include <QStringList>
 #include <QTimer>
 
-static QString iconCachePath(const AppStream::Icon &icon)
-{
-    Q_ASSERT(icon.kind() == AppStream::Icon::KindRemote);
-    return QStringLiteral("%1/icons/%2").arg(QStandardPaths::writableLocation(QStandardPaths::CacheLocation), icon.url().fileName());
-}
-
 FlatpakResource::FlatpakResource(const AppStream::Component &component, FlatpakInstallation *installation, FlatpakBackend *parent)
     : AbstractResource(parent)
     , m_appdata(component)
     , m_id({installation, QString(), FlatpakResource::DesktopApp, component.id(), QString(), QString()})
     , m_downloadSize(0)
     , m_installedSize(0)
-    , m_propertyStates({{DownloadSize, NotKnownYet}, {InstalledSize, NotKnownYet}, {RequiredRuntime, NotKnownYet}})
+    , m_propertyStates{{NotKnownYet, NotKnownYet, NotKnownYet}}
     , m_state(AbstractResource::None)
 {
     setObjectName(packageName());
-
-    // Start fetching remote icons during initialization
-    const auto icons = m_appdata.icons();
-    if (!icons.isEmpty()) {
-        foreach (const AppStream::Icon &icon, icons) {
-            if (icon.kind() == AppStream::Icon::KindRemote) {
-                const QString fileName = iconCachePath(icon);
-                if (!QFileInfo::exists(fileName)) {
-                    const QDir cacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
-                    // Create $HOME/.cache/discover/icons folder
-                    cacheDir.mkdir(QStringLiteral("icons"));
-                    QNetworkAccessManager *manager = new QNetworkAccessManager(this);
-                    connect(manager, &QNetworkAccessManager::finished, this, [this, icon, fileName, manager](QNetworkReply *reply) {
-                        if (reply->error() == QNetworkReply::NoError) {
-                            QByteArray iconData = reply->readAll();
-                            QFile file(fileName);
-                            if (file.open(QIODevice::WriteOnly)) {
-                                file.write(iconData);
-                            }
-                            file.close();
-                            Q_EMIT iconChanged();
-                        }
-                        manager->deleteLater();
-                    });
-                    manager->get(QNetworkRequest(icon.url()));
-                }
-            }
-        }
-    }
 }
 
 AppStream::Component FlatpakResource::appstreamComponent() const
@@ -168,49 +131,53 @@ int FlatpakResource::downloadSize() const
 }
 
 QVariant FlatpakResource::icon() const
+{
+    if (!m_bundledIcon.isNull()) {
+        return QIcon(m_bundledIcon);
+    }
+
+    const QIcon ret = IconLoader::global()->icon(m_iconPath + m_appdata.id(), [this] {
+        return buildIcon();
+    });
+    // Not kept by the loader, we look for the files again once the appstream data brings them
+    return ret.isNull() ? QIcon::fromTheme(QStringLiteral("package-x-generic")) : ret;
+}
+
+QIcon FlatpakResource::buildIcon() const
 {
     QIcon ret;
     const auto icons = m_appdata.icons();
 
-    if (!m_bundledIcon.isNull()) {
-        ret = QIcon(m_bundledIcon);
-    } else if (icons.isEmpty()) {
-        ret = QIcon::fromTheme(QStringLiteral("package-x-generic"));
-    } else
-        foreach (const AppStream::Icon &icon, icons) {
-            switch (icon.kind()) {
-            case AppStream::Icon::KindLocal:
-            case AppStream::Icon::KindCached: {
-                const QString path = m_iconPath + icon.url().path();
-                if (QFileInfo::exists(path)) {
-                    ret.addFile(path, icon.size());
-                } else {
-                    const QString altPath = m_iconPath + QStringLiteral("%1x%2/").arg(icon.size().width()).arg(icon.size().height()) + icon.url().path();
-                    if (QFileInfo::exists(altPath)) {
-                        ret.addFile(altPath, icon.size());
-                    }
-                }
-            } break;
-            case AppStream::Icon::KindStock: {
-                const auto ret = QIcon::fromTheme(icon.name());
-                if (!ret.isNull())
-                    return ret;
-                break;
-            }
-            case AppStream::Icon::KindRemote: {
-                const QString fileName = iconCachePath(icon);
-                if (QFileInfo::exists(fileName)) {
-                    ret.addFile(fileName, icon.size());
+    foreach (const AppStream::Icon &icon, icons) {
+        switch (icon.kind()) {
+        case AppStream::Icon::KindLocal:
+        case AppStream::Icon::KindCached: {
+            const QString path = m_iconPath + icon.url().path();
+            if (QFileInfo::exists(path)) {
+                ret.addFile(path, icon.size());
+            } else {
+                const QString altPath = m_iconPath + QStringLiteral("%1x%2/").arg(icon.size().width()).arg(icon.size().height()) + icon.url().path();
+                if (QFileInfo::exists(altPath)) {
+                    ret.addFile(altPath, icon.size());
                 }
-                break;
             }
-            case AppStream::Icon::KindUnknown:
-                break;
+        } break;
+        case AppStream::Icon::KindStock: {
+            const auto ret = QIcon::fromTheme(icon.name());
+            if (!ret.isNull())
+                return ret;
+            break;
+        }
+        case AppStream::Icon::KindRemote: {
+            const QString fileName = IconLoader::global()->fetchRemote(icon.url(), const_cast<FlatpakResource *>(this));
+            if (!fileName.isEmpty()) {
+                ret.addFile(fileName, icon.size());
             }
+            break;
+        }
+        case AppStream::Icon::KindUnknown:
+            break;
         }
-
-    if (ret.isNull()) {
-        ret = QIcon::fromTheme(QStringLiteral("package-x-generic"));
     }
 
     return ret;
@@ -431,12 +398,12 @@ void FlatpakResource::fetchScreenshots()
 
 void FlatpakResource::setArch(const QString &arch)
 {
-    m_id.arch = arch;
+    m_id.arch = StringInterner::intern(arch);
 }
 
 void FlatpakResource::setBranch(const QString &branch)
 {
-    m_id.branch = branch;
+    m_id.branch = StringInterner::intern(branch);
 }
 
 void FlatpakResource::setBundledIcon(const QPixmap &pixmap)
@@ -460,7 +427,7 @@ void FlatpakResource::setDownloadSize(int size)
 
 void FlatpakResource::setFlatpakFileType(const QString &fileType)
 {
-    m_flatpakFileType = fileType;
+    m_flatpakFileType = StringInterner::intern(fileType);
 }
 
 void FlatpakResource::setFlatpakName(const QString &name)
@@ -484,7 +451,7 @@ void FlatpakResource::setInstalledSize(int size)
 
 void FlatpakResource::setOrigin(const QString &origin)
 {
-    m_id.origin = origin;
+    m_id.origin = StringInterner::intern(origin);
 }
 
 void FlatpakResource::setPropertyState(FlatpakResource::PropertyKind kind, FlatpakResource::PropertyState newState)
@@ -504,7 +471,7 @@ void FlatpakResource::setResourceFile(const QUrl &url)
 
 void FlatpakResource::setRuntime(const QString &runtime)
 {
-    m_runtime = runtime;
+    m_runtime = StringInterner::intern(runtime);
 
     setPropertyState(RequiredRuntime, AlreadyKnown);
 }
@@ -592,3 +559,13 @@ QStringList FlatpakResource::mimetypes() const
 {
     return m_appdata.provided(AppStream::Provided::KindMimetype).items();
 }
+
+size_t FlatpakResource::memoryFootprint() const
+{
+    return AbstractResource::memoryFootprint() + sizeof(FlatpakResource) - sizeof(AbstractResource) //
+        + StringInterner::footprint(m_id.origin) + StringInterner::footprint(m_id.id) //
+        + StringInterner::footprint(m_id.branch) + StringInterner::footprint(m_id.arch) //
+        + StringInterner::footprint(m_commit) + StringInterner::footprint(m_flatpakFileType) //
+        + StringInterner::footprint(m_flatpakName) + StringInterner::footprint(m_iconPath) //
+        + StringInterner::footprint(m_runtime);
+}
@@ -14,7 +14,9 @@
 
 #include <AppStreamQt/component.h>
 
+#include <QIcon>
 #include <QPixmap>
+#include <array>
 
 class AddonList;
 class FlatpakBackend;
@@ -133,6 +135,7 @@ public:
     void fetchScreenshots() override;
     QSet<QString> alternativeAppstreamIds() const override;
     QStringList mimetypes() const override;
+    size_t memoryFootprint() const override;
 
     void setBranch(const QString &branch);
     void setBundledIcon(const QPixmap &pixmap);
@@ -159,6 +162,7 @@ Q_SIGNALS:
     void propertyStateChanged(FlatpakResource::PropertyKind kind, FlatpakResource::PropertyState state);
 
 private:
+    QIcon buildIcon() const;
     void setArch(const QString &arch);
     void setCommit(const QString &commit);
 
@@ -172,7 +176,7 @@ private:
     QString m_flatpakName;
     QString m_iconPath;
     int m_installedSize;
-    QHash<PropertyKind, PropertyState> m_propertyStates;
+    std::array<PropertyState, RequiredRuntime + 1> m_propertyStates;
     QUrl m_resourceFile;
     QString m_runtime;
     AbstractResource::State m_state;
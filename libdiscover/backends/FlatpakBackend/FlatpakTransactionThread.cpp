@@ -11,6 +11,10 @@
 #include <QDebug>
 
 static int FLATPAK_CLI_UPDATE_FREQUENCY = 150;
+// Speed and remaining time only change once per sample, in microseconds
+static const gint64 s_speedSampleInterval = G_USEC_PER_SEC;
+// Weight of the last sample in the reported speed
+static const double s_speedSmoothing = 0.3;
 
 gboolean add_new_remote_cb(FlatpakTransaction * /*object*/, gint /*reason*/, gchar *from_id, gchar *suggested_remote_name, gchar *url, gpointer user_data)
 {
@@ -26,42 +30,50 @@ static void progress_changed_cb(FlatpakTransactionProgress *progress, gpointer u
 {
     FlatpakTransactionThread *obj = (FlatpakTransactionThread *)user_data;
 
-    obj->setProgress(qMin(99, flatpak_transaction_progress_get_progress(progress)));
-
-#ifdef FLATPAK_VERBOSE_PROGRESS
-    guint64 start_time = flatpak_transaction_progress_get_start_time(progress);
-    guint64 elapsed_time = (g_get_monotonic_time() - start_time) / G_USEC_PER_SEC;
-    if (elapsed_time > 0) {
-        guint64 transferred = flatpak_transaction_progress_get_bytes_transferred(progress);
-        obj->setSpeed(transferred / elapsed_time);
-    }
+    const auto ref = static_cast<const char *>(g_object_get_data(G_OBJECT(progress), "discover-ref"));
+#if FLATPAK_CHECK_VERSION(1, 1, 2)
+    const guint64 transferred = flatpak_transaction_progress_get_bytes_transferred(progress);
+#else
+    const guint64 transferred = 0;
 #endif
+    obj->setOperationProgress(QString::fromUtf8(ref), flatpak_transaction_progress_get_progress(progress), transferred);
 }
 
-void new_operation_cb(FlatpakTransaction * /*object*/, FlatpakTransactionOperation * /*operation*/, FlatpakTransactionProgress *progress, gpointer user_data)
+void new_operation_cb(FlatpakTransaction * /*object*/, FlatpakTransactionOperation *operation, FlatpakTransactionProgress *progress, gpointer user_data)
 {
     FlatpakTransactionThread *obj = (FlatpakTransactionThread *)user_data;
 
+    // Every operation gets its own progress, remember which ref it's about
+    g_object_set_data_full(G_OBJECT(progress), "discover-ref", g_strdup(flatpak_transaction_operation_get_ref(operation)), g_free);
     g_signal_connect(progress, "changed", G_CALLBACK(progress_changed_cb), obj);
     flatpak_transaction_progress_set_update_frequency(progress, FLATPAK_CLI_UPDATE_FREQUENCY);
 }
 
-void operation_error_cb(FlatpakTransaction * /*object*/, FlatpakTransactionOperation * /*operation*/, GError *error, gint /*details*/, gpointer user_data)
+gboolean operation_error_cb(FlatpakTransaction * /*object*/, FlatpakTransactionOperation *operation, GError *error, gint /*details*/, gpointer user_data)
+{
+    FlatpakTransactionThread *obj = (FlatpakTransactionThread *)user_data;
+    obj->addOperationError(QString::fromUtf8(flatpak_transaction_operation_get_ref(operation)), QString::fromUtf8(error->message));
+    // Carry on with the other operations, they don't depend on this one or flatpak skips them already
+    return true;
+}
+
+void operation_done_cb(FlatpakTransaction * /*object*/, FlatpakTransactionOperation *operation, const gchar * /*commit*/, gint /*result*/, gpointer user_data)
 {
     FlatpakTransactionThread *obj = (FlatpakTransactionThread *)user_data;
-    obj->addErrorMessage(QString::fromUtf8(error->message));
+    obj->addOperationDone(QString::fromUtf8(flatpak_transaction_operation_get_ref(operation)));
 }
 
-FlatpakTransactionThread::FlatpakTransactionThread(FlatpakResource *app, Transaction::Role role)
+FlatpakTransactionThread::FlatpakTransactionThread(const QVector<FlatpakResource *> &apps, Transaction::Role role)
     : QThread()
     , m_result(false)
-    , m_app(app)
+    , m_apps(apps)
     , m_role(role)
 {
+    Q_ASSERT(!m_apps.isEmpty());
     m_cancellable = g_cancellable_new();
 
     g_autoptr(GError) localError = nullptr;
-    m_transaction = flatpak_transaction_new_for_installation(app->installation(), m_cancellable, &localError);
+    m_transaction = flatpak_transaction_new_for_installation(m_apps.constFirst()->installation(), m_cancellable, &localError);
     if (localError) {
         addErrorMessage(QString::fromUtf8(localError->message));
         qWarning() << "Failed to create transaction" << m_errorMessage;
@@ -69,6 +81,7 @@ FlatpakTransactionThread::FlatpakTransactionThread(FlatpakResource *app, Transac
         g_signal_connect(m_transaction, "add-new-remote", G_CALLBACK(add_new_remote_cb), this);
         g_signal_connect(m_transaction, "new-operation", G_CALLBACK(new_operation_cb), this);
         g_signal_connect(m_transaction, "operation-error", G_CALLBACK(operation_error_cb), this);
+        g_signal_connect(m_transaction, "operation-done", G_CALLBACK(operation_done_cb), this);
     }
 }
 
@@ -83,84 +96,96 @@ void FlatpakTransactionThread::cancel()
     g_cancellable_cancel(m_cancellable);
 }
 
-void FlatpakTransactionThread::run()
+bool FlatpakTransactionThread::addToTransaction(FlatpakResource *app)
 {
-    if (!m_transaction)
-        return;
     g_autoptr(GError) localError = nullptr;
+    const QString refName = app->ref();
 
-    const QString refName = m_app->ref();
-
+    bool correct = false;
     if (m_role == Transaction::Role::InstallRole) {
-        bool correct = false;
-        if (m_app->state() == AbstractResource::Upgradeable && m_app->isInstalled()) {
+        if (app->state() == AbstractResource::Upgradeable && app->isInstalled()) {
             correct = flatpak_transaction_add_update(m_transaction, refName.toUtf8().constData(), nullptr, nullptr, &localError);
         } else {
-            if (m_app->flatpakFileType() == QLatin1String("flatpak")) {
-                g_autoptr(GFile) file = g_file_new_for_path(m_app->resourceFile().toLocalFile().toUtf8().constData());
+            if (app->flatpakFileType() == QLatin1String("flatpak")) {
+                g_autoptr(GFile) file = g_file_new_for_path(app->resourceFile().toLocalFile().toUtf8().constData());
                 if (!file) {
                     qWarning() << "Failed to install bundled application" << refName;
-                    m_result = false;
-                    return;
+                    m_failedRefs.insert(refName);
+                    return false;
                 }
                 correct = flatpak_transaction_add_install_bundle(m_transaction, file, nullptr, &localError);
             } else {
                 correct = flatpak_transaction_add_install(m_transaction, //
-                                                          m_app->origin().toUtf8().constData(),
+                                                          app->origin().toUtf8().constData(),
                                                           refName.toUtf8().constData(),
                                                           nullptr,
                                                           &localError);
             }
         }
-
-        if (!correct) {
-            m_result = false;
-            m_errorMessage = QString::fromUtf8(localError->message);
-            // We are done so we can set the progress to 100
-            setProgress(100);
-            qWarning() << "Failed to install" << refName << ':' << m_errorMessage;
-            return;
-        }
     } else if (m_role == Transaction::Role::RemoveRole) {
-        if (!flatpak_transaction_add_uninstall(m_transaction, refName.toUtf8().constData(), &localError)) {
-            m_result = false;
-            m_errorMessage = QString::fromUtf8(localError->message);
-            // We are done so we can set the progress to 100
-            setProgress(100);
-            qWarning() << "Failed to uninstall" << refName << ':' << m_errorMessage;
-            return;
-        }
+        correct = flatpak_transaction_add_uninstall(m_transaction, refName.toUtf8().constData(), &localError);
+    }
+
+    if (!correct) {
+        addOperationError(refName, QString::fromUtf8(localError->message));
+        qWarning() << "Failed to add" << refName << "to the transaction:" << localError->message;
+    }
+    return correct;
+}
+
+void FlatpakTransactionThread::run()
+{
+    if (!m_transaction)
+        return;
+    g_autoptr(GError) localError = nullptr;
+
+    bool added = false;
+    for (FlatpakResource *app : m_apps) {
+        added |= addToTransaction(app);
+    }
+    if (!added) {
+        m_result = false;
+        // We are done so we can set the progress to 100
+        setProgress(100);
+        return;
     }
 
     m_result = flatpak_transaction_run(m_transaction, m_cancellable, &localError);
     if (!m_result) {
-        m_errorMessage = QString::fromUtf8(localError->message);
-#if defined(FLATPAK_LIST_UNUSED_REFS)
+        addErrorMessage(QString::fromUtf8(localError->message));
     } else {
-        const auto installation = flatpak_transaction_get_installation(m_transaction);
-        g_autoptr(GPtrArray) refs = flatpak_installation_list_unused_refs(installation, nullptr, m_cancellable, nullptr);
-        if (refs->len > 0) {
-            g_autoptr(GError) localError = nullptr;
-            qDebug() << "found unused refs:" << refs->len;
-            auto transaction = flatpak_transaction_new_for_installation(installation, m_cancellable, &localError);
-            for (uint i = 0; i < refs->len; i++) {
-                FlatpakRef *ref = FLATPAK_REF(g_ptr_array_index(refs, i));
-                g_autofree gchar *strRef = flatpak_ref_format_ref(ref);
-                qDebug() << "unused ref:" << strRef;
-                if (!flatpak_transaction_add_uninstall(transaction, strRef, &localError)) {
-                    qDebug() << "failed to uninstall unused ref" << refName << localError->message;
-                    break;
-                }
-            }
-            if (!flatpak_transaction_run(transaction, m_cancellable, &localError)) {
-                qWarning() << "could not properly clean the elements" << refs->len << localError->message;
-            }
-            g_object_unref(m_transaction);
-        }
-#endif
+        // Once for all the refs in the transaction
+        removeUnusedRefs();
     }
     // We are done so we can set the progress to 100
     setProgress(100);
+    setSpeed(0);
+    setRemainingTime(0);
+}
+
+void FlatpakTransactionThread::removeUnusedRefs()
+{
+#if defined(FLATPAK_LIST_UNUSED_REFS)
+    const auto installation = flatpak_transaction_get_installation(m_transaction);
+    g_autoptr(GPtrArray) refs = flatpak_installation_list_unused_refs(installation, nullptr, m_cancellable, nullptr);
+    if (refs->len > 0) {
+        g_autoptr(GError) localError = nullptr;
+        qDebug() << "found unused refs:" << refs->len;
+        g_autoptr(FlatpakTransaction) transaction = flatpak_transaction_new_for_installation(installation, m_cancellable, &localError);
+        for (uint i = 0; i < refs->len; i++) {
+            FlatpakRef *ref = FLATPAK_REF(g_ptr_array_index(refs, i));
+            g_autofree gchar *strRef = flatpak_ref_format_ref(ref);
+            qDebug() << "unused ref:" << strRef;
+            if (!flatpak_transaction_add_uninstall(transaction, strRef, &localError)) {
+                qDebug() << "failed to uninstall unused ref" << strRef << localError->message;
+                break;
+            }
+        }
+        if (!flatpak_transaction_run(transaction, m_cancellable, &localError)) {
+            qWarning() << "could not properly clean the elements" << refs->len << localError->message;
+        }
+    }
+#endif
 }
 
 void FlatpakTransactionThread::setProgress(int progress)
@@ -180,6 +205,14 @@ void FlatpakTransactionThread::setSpeed(quint64 speed)
     }
 }
 
+void FlatpakTransactionThread::setRemainingTime(uint seconds)
+{
+    if (m_remainingTime != seconds) {
+        m_remainingTime = seconds;
+        Q_EMIT remainingTimeChanged(m_remainingTime);
+    }
+}
+
 QString FlatpakTransactionThread::errorMessage() const
 {
     return m_errorMessage;
@@ -190,9 +223,90 @@ bool FlatpakTransactionThread::result() const
     return m_result;
 }
 
+bool FlatpakTransactionThread::result(const QString &ref) const
+{
+    if (m_failedRefs.contains(ref))
+        return false;
+    // The transaction fails as a whole when some of its operations did, only the ones that finished went through
+    return m_result || m_doneRefs.contains(ref);
+}
+
+void FlatpakTransactionThread::setOperationProgress(const QString &ref, int progress, guint64 bytesTransferred)
+{
+    if (m_operationsCount == 0) {
+        GList *operations = flatpak_transaction_get_operations(m_transaction);
+        m_operationsCount = g_list_length(operations);
+#if FLATPAK_CHECK_VERSION(1, 1, 2)
+        for (GList *it = operations; it; it = it->next) {
+            m_downloadSize += flatpak_transaction_operation_get_download_size(FLATPAK_TRANSACTION_OPERATION(it->data));
+        }
+#endif
+        g_list_free_full(operations, g_object_unref);
+    }
+
+    Operation &operation = m_operations[ref];
+    operation.bytesTransferred = bytesTransferred;
+    // Only what changed is sent to the GUI thread, flatpak reports a lot more often than that
+    if (operation.progress != progress) {
+        operation.progress = progress;
+        Q_EMIT operationProgressChanged(ref, qMin(99, progress));
+
+        // Operations that didn't start yet count as 0
+        int total = 0;
+        for (const Operation &op : qAsConst(m_operations)) {
+            total += op.progress;
+        }
+        setProgress(qMin(99, total / qMax(m_operationsCount, m_operations.size())));
+    }
+    updateSpeed();
+}
+
+void FlatpakTransactionThread::updateSpeed()
+{
+    guint64 transferred = 0;
+    for (const Operation &op : qAsConst(m_operations)) {
+        transferred += op.bytesTransferred;
+    }
+
+    const gint64 now = g_get_monotonic_time();
+    if (m_lastSampleTime == 0) {
+        m_lastSampleTime = now;
+        m_lastSampleBytes = transferred;
+        return;
+    }
+
+    const gint64 elapsed = now - m_lastSampleTime;
+    if (elapsed < s_speedSampleInterval)
+        return;
+
+    const double current = transferred > m_lastSampleBytes ? double(transferred - m_lastSampleBytes) * G_USEC_PER_SEC / elapsed : 0;
+    // Averaged with the previous samples, so the numbers don't jump around
+    m_smoothedSpeed = m_smoothedSpeed < 0 ? current : s_speedSmoothing * current + (1 - s_speedSmoothing) * m_smoothedSpeed;
+    m_lastSampleTime = now;
+    m_lastSampleBytes = transferred;
+
+    setSpeed(m_smoothedSpeed);
+    if (m_downloadSize > transferred && m_smoothedSpeed >= 1) {
+        setRemainingTime((m_downloadSize - transferred) / m_smoothedSpeed);
+    } else {
+        setRemainingTime(0);
+    }
+}
+
 void FlatpakTransactionThread::addErrorMessage(const QString &error)
 {
     if (!m_errorMessage.isEmpty())
         m_errorMessage.append(QLatin1Char('\n'));
     m_errorMessage.append(error);
 }
+
+void FlatpakTransactionThread::addOperationError(const QString &ref, const QString &error)
+{
+    m_failedRefs.insert(ref);
+    addErrorMessage(error);
+}
+
+void FlatpakTransactionThread::addOperationDone(const QString &ref)
+{
+    m_doneRefs.insert(ref);
+}
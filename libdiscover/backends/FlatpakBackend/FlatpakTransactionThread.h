@@ -11,7 +11,10 @@
 #include <gio/gio.h>
 #include <glib.h>
 
+#include <QHash>
+#include <QSet>
 #include <QThread>
+#include <QVector>
 #include <Transaction/Transaction.h>
 
 class FlatpakResource;
@@ -19,7 +22,8 @@ class FlatpakTransactionThread : public QThread
 {
     Q_OBJECT
 public:
-    FlatpakTransactionThread(FlatpakResource *app, Transaction::Role role);
+    /// All of @p apps are expected to be in the same installation
+    FlatpakTransactionThread(const QVector<FlatpakResource *> &apps, Transaction::Role role);
     ~FlatpakTransactionThread() override;
 
     void cancel();
@@ -31,27 +35,52 @@ public:
     }
     void setProgress(int progress);
     void setSpeed(quint64 speed);
+    void setRemainingTime(uint seconds);
+    void setOperationProgress(const QString &ref, int progress, guint64 bytesTransferred);
 
     QString errorMessage() const;
     bool result() const;
+    /// @returns whether the operation on @p ref succeeded
+    bool result(const QString &ref) const;
 
     void addErrorMessage(const QString &error);
+    void addOperationError(const QString &ref, const QString &error);
+    void addOperationDone(const QString &ref);
 
 Q_SIGNALS:
     void progressChanged(int progress);
+    void operationProgressChanged(const QString &ref, int progress);
     void speedChanged(quint64 speed);
+    void remainingTimeChanged(uint seconds);
     void passiveMessage(const QString &msg);
 
 private:
+    bool addToTransaction(FlatpakResource *app);
+    void removeUnusedRefs();
+    void updateSpeed();
+
     FlatpakTransaction *m_transaction;
 
     bool m_result = false;
     int m_progress = 0;
     quint64 m_speed = 0;
+    uint m_remainingTime = 0;
     QString m_errorMessage;
     GCancellable *m_cancellable;
-    FlatpakResource *const m_app;
+    const QVector<FlatpakResource *> m_apps;
     const Transaction::Role m_role;
+    struct Operation {
+        int progress = 0;
+        guint64 bytesTransferred = 0;
+    };
+    QHash<QString, Operation> m_operations;
+    int m_operationsCount = 0;
+    guint64 m_downloadSize = 0;
+    gint64 m_lastSampleTime = 0;
+    guint64 m_lastSampleBytes = 0;
+    double m_smoothedSpeed = -1;
+    QSet<QString> m_failedRefs;
+    QSet<QString> m_doneRefs;
 };
 
 #endif // FLATPAKTRANSACTIONJOB_H
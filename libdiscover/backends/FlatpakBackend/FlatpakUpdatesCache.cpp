@@ -0,0 +1,60 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "FlatpakUpdatesCache.h"
+#include <UpdatesCache.h>
+
+/// How long a published list of updates is trusted, in seconds
+static const int s_flatpakUpdatesMaxAge = 30 * 60;
+
+GPtrArray *flatpakInstalledRefsForUpdate(FlatpakInstallation *installation, GCancellable *cancellable, GError **error, bool allowCached)
+{
+    g_autoptr(GFile) path = flatpak_installation_get_path(installation);
+    g_autofree char *pathString = g_file_get_path(path);
+    UpdatesCache cache(QLatin1String("flatpak-") + QString::fromUtf8(flatpak_installation_get_id(installation)));
+    const QString state = UpdatesCache::stateOfFiles({QString::fromUtf8(pathString) + QLatin1String("/.changed")});
+
+    QVector<UpdatesCache::Update> published;
+    if (allowCached && cache.load(state, s_flatpakUpdatesMaxAge, &published)) {
+        GPtrArray *refs = g_ptr_array_new_with_free_func(g_object_unref);
+        for (const auto &update : qAsConst(published)) {
+            g_autoptr(FlatpakRef) parsed = flatpak_ref_parse(update.id.toUtf8().constData(), nullptr);
+            FlatpakInstalledRef *ref = !parsed ? nullptr
+                                               : flatpak_installation_get_installed_ref(installation,
+                                                                                        flatpak_ref_get_kind(parsed),
+                                                                                        flatpak_ref_get_name(parsed),
+                                                                                        flatpak_ref_get_arch(parsed),
+                                                                                        flatpak_ref_get_branch(parsed),
+                                                                                        cancellable,
+                                                                                        nullptr);
+            if (!ref) {
+                // Not installed anymore, it's outdated after all
+                g_ptr_array_unref(refs);
+                refs = nullptr;
+                break;
+            }
+            g_ptr_array_add(refs, ref);
+        }
+        if (refs)
+            return refs;
+    }
+
+    GPtrArray *refs = flatpak_installation_list_installed_refs_for_update(installation, cancellable, error);
+    if (refs) {
+        QVector<UpdatesCache::Update> updates;
+        updates.reserve(refs->len);
+        for (uint i = 0; i < refs->len; i++) {
+            FlatpakInstalledRef *ref = FLATPAK_INSTALLED_REF(g_ptr_array_index(refs, i));
+            g_autofree char *id = flatpak_ref_format_ref(FLATPAK_REF(ref));
+            UpdatesCache::Update update;
+            update.id = QString::fromUtf8(id);
+            update.summary = QString::fromUtf8(flatpak_installed_ref_get_appdata_summary(ref));
+            updates.append(update);
+        }
+        cache.store(state, updates);
+    }
+    return refs;
+}
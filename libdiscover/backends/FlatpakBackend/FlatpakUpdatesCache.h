@@ -0,0 +1,23 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#ifndef FLATPAKUPDATESCACHE_H
+#define FLATPAKUPDATESCACHE_H
+
+#include "flatpak-helper.h"
+
+// Shared by the backend and the notifier, so the remotes are only asked in one of them
+
+/**
+ * Drop-in for flatpak_installation_list_installed_refs_for_update() that reuses
+ * the refs published by the other process if the installation didn't change since,
+ * unless @p allowCached is false. The refs found are published either way.
+ *
+ * Flatpak touches the .changed file of the installation on every deploy, which is what it monitors too.
+ */
+GPtrArray *flatpakInstalledRefsForUpdate(FlatpakInstallation *installation, GCancellable *cancellable, GError **error, bool allowCached = true);
+
+#endif // FLATPAKUPDATESCACHE_H
@@ -135,23 +135,6 @@ void FwupdBackend::addUpdates()
     }
 }
 
-QByteArray FwupdBackend::getChecksum(const QString &filename, QCryptographicHash::Algorithm hashAlgorithm)
-{
-    QFile f(filename);
-    if (!f.open(QFile::ReadOnly)) {
-        qWarning() << "could not open to check" << filename;
-        return {};
-    }
-
-    QCryptographicHash hash(hashAlgorithm);
-    if (!hash.addData(&f)) {
-        qWarning() << "could not read to check" << filename;
-        return {};
-    }
-
-    return hash.result().toHex();
-}
-
 FwupdResource *FwupdBackend::createApp(FwupdDevice *device)
 {
     FwupdRelease *release = fwupd_device_get_release_default(device);
@@ -185,16 +168,15 @@ FwupdResource *FwupdBackend::createApp(FwupdDevice *device)
         return nullptr;
     }
 
-    /* Checking for firmware in the cache? */
-    const QString filename_cache = app->cacheFile();
-    if (QFile::exists(filename_cache)) {
-        /* Currently LVFS supports SHA1 only*/
-        const QByteArray checksum_tmp(fwupd_checksum_get_by_kind(checksums, G_CHECKSUM_SHA1));
-        const QByteArray checksum = getChecksum(filename_cache, QCryptographicHash::Sha1);
-        if (checksum_tmp != checksum) {
-            QFile::remove(filename_cache);
-        }
+    /* The cached firmware is checked against it by the transaction, away from the GUI thread */
+    const QByteArray checksum(fwupd_checksum_get_best(checksums));
+    const auto algorithms = gchecksumToQChryptographicHash();
+    const auto algorithm = algorithms.constFind(fwupd_checksum_guess_kind(checksum.constData()));
+    if (algorithm == algorithms.constEnd()) {
+        qWarning() << "Fwupd Error: " << app->name() << "[" << app->id() << "] has an unsupported checksum, ignoring as unsafe" << checksum;
+        return nullptr;
     }
+    app->setChecksum(checksum, *algorithm);
 
     app->setState(AbstractResource::Upgradeable);
     return app.take();
@@ -85,7 +85,6 @@ private:
     void addResource(FwupdResource *res);
 
     static QMap<GChecksumType, QCryptographicHash::Algorithm> gchecksumToQChryptographicHash();
-    static QByteArray getChecksum(const QString &filename, QCryptographicHash::Algorithm hashAlgorithm);
 
     FwupdResource *createRelease(FwupdDevice *device);
     FwupdResource *createApp(FwupdDevice *device);
@@ -116,6 +116,23 @@ public:
 
     QString cacheFile() const;
 
+    /// Hex encoded checksum the downloaded firmware must have, computed with checksumAlgorithm()
+    QByteArray checksum() const
+    {
+        return m_checksum;
+    }
+
+    QCryptographicHash::Algorithm checksumAlgorithm() const
+    {
+        return m_checksumAlgorithm;
+    }
+
+    void setChecksum(const QByteArray &checksum, QCryptographicHash::Algorithm algorithm)
+    {
+        m_checksum = checksum;
+        m_checksumAlgorithm = algorithm;
+    }
+
 private:
     void setDeviceDetails(FwupdDevice *device);
 
@@ -137,6 +154,8 @@ private:
     int m_size = 0;
 
     QString m_updateURI;
+    QByteArray m_checksum;
+    QCryptographicHash::Algorithm m_checksumAlgorithm = QCryptographicHash::Sha1;
     bool m_isDeviceLocked = false; // True if device is locked!
     bool m_isOnlyOffline = false; // True if only offline updates
     bool m_isLiveUpdatable = false; // True if device is live updatable
@@ -7,13 +7,16 @@
 
 #include "FwupdTransaction.h"
 
+#include <QFutureWatcher>
 #include <QTimer>
+#include <QtConcurrentRun>
 #include <resources/AbstractBackendUpdater.h>
 
 FwupdTransaction::FwupdTransaction(FwupdResource *app, FwupdBackend *backend)
     : Transaction(backend, app, Transaction::InstallRole, {})
     , m_app(app)
     , m_backend(backend)
+    , m_cancellable(g_cancellable_new())
 {
     setCancellable(true);
     setStatus(QueuedStatus);
@@ -22,7 +25,13 @@ FwupdTransaction::FwupdTransaction(FwupdResource *app, FwupdBackend *backend)
     QTimer::singleShot(0, this, &FwupdTransaction::install);
 }
 
-FwupdTransaction::~FwupdTransaction() = default;
+FwupdTransaction::~FwupdTransaction()
+{
+    if (m_percentageHandler)
+        g_signal_handler_disconnect(m_backend->client, m_percentageHandler);
+    g_cancellable_cancel(m_cancellable);
+    g_object_unref(m_cancellable);
+}
 
 void FwupdTransaction::install()
 {
@@ -40,49 +49,178 @@ void FwupdTransaction::install()
     }
 
     const QString fileName = m_app->cacheFile();
-    if (!QFileInfo::exists(fileName)) {
-        const QUrl uri(m_app->updateURI());
-        setStatus(DownloadingStatus);
-        QNetworkAccessManager *manager = new QNetworkAccessManager(this);
-        auto reply = manager->get(QNetworkRequest(uri));
-        QFile *file = new QFile(fileName);
-        if (!file->open(QFile::WriteOnly)) {
-            qWarning() << "Fwupd Error: Could not open to write" << fileName << uri;
-            setStatus(DoneWithErrorStatus);
-            file->deleteLater();
-            return;
-        }
-
-        connect(reply, &QNetworkReply::finished, this, [this, file, reply]() {
-            file->close();
-            file->deleteLater();
-
-            if (reply->error() != QNetworkReply::NoError) {
-                qWarning() << "Fwupd Error: Could not download" << reply->url() << reply->errorString();
-                file->remove();
-                setStatus(DoneWithErrorStatus);
+    if (QFileInfo::exists(fileName)) {
+        // It might have been left by another release or tampered with, check it before flashing
+        hashFile(fileName, [this, fileName](const QSharedPointer<QCryptographicHash> &hash) {
+            if (checksumMatches(hash.data())) {
+                fwupdInstall(fileName);
             } else {
-                fwupdInstall(file->fileName());
+                qWarning() << "Fwupd Error: Discarding cached firmware with a wrong checksum" << fileName;
+                QFile::remove(fileName);
+                resumeDownload();
             }
         });
-        connect(reply, &QNetworkReply::readyRead, this, [file, reply]() {
-            file->write(reply->readAll());
-        });
     } else {
-        fwupdInstall(fileName);
+        resumeDownload();
+    }
+}
+
+QString FwupdTransaction::partialFile() const
+{
+    return m_app->cacheFile() + QLatin1String(".part");
+}
+
+void FwupdTransaction::hashFile(const QString &fileName, const std::function<void(const QSharedPointer<QCryptographicHash> &)> &callback)
+{
+    const auto algorithm = m_app->checksumAlgorithm();
+    auto fw = new QFutureWatcher<QSharedPointer<QCryptographicHash>>(this);
+    connect(fw, &QFutureWatcher<QSharedPointer<QCryptographicHash>>::finished, this, [this, fw, callback] {
+        fw->deleteLater();
+        if (status() != CancelledStatus)
+            callback(fw->result());
+    });
+    fw->setFuture(QtConcurrent::run([fileName, algorithm] {
+        QSharedPointer<QCryptographicHash> hash(new QCryptographicHash(algorithm));
+        QFile file(fileName);
+        if (file.open(QIODevice::ReadOnly) && !hash->addData(&file)) {
+            qWarning() << "could not read to check" << fileName;
+        }
+        return hash;
+    }));
+}
+
+bool FwupdTransaction::checksumMatches(QCryptographicHash *hash) const
+{
+    return hash->result().toHex() == m_app->checksum();
+}
+
+void FwupdTransaction::resumeDownload()
+{
+    setStatus(DownloadingStatus);
+    // What was downloaded before an interruption is hashed again, the rest as it arrives
+    hashFile(partialFile(), [this](const QSharedPointer<QCryptographicHash> &hash) {
+        download(hash);
+    });
+}
+
+void FwupdTransaction::download(const QSharedPointer<QCryptographicHash> &hash)
+{
+    m_hash = hash;
+    m_file = new QFile(partialFile(), this);
+    if (!m_file->open(QFile::WriteOnly | QFile::Append)) {
+        qWarning() << "Fwupd Error: Could not open to write" << m_file->fileName();
+        setStatus(DoneWithErrorStatus);
+        return;
+    }
+    m_offset = m_file->size();
+
+    QNetworkRequest request(m_app->updateURI());
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
+    if (m_offset > 0) {
+        request.setRawHeader("Range", "bytes=" + QByteArray::number(m_offset) + '-');
+    }
+
+    QNetworkAccessManager *manager = new QNetworkAccessManager(this);
+    m_reply = manager->get(request);
+    connect(m_reply, &QNetworkReply::metaDataChanged, this, [this] {
+        // The server doesn't do ranges and sends it all again
+        if (m_offset > 0 && m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 200) {
+            m_file->resize(0);
+            m_hash->reset();
+            m_offset = 0;
+        }
+    });
+    connect(m_reply, &QNetworkReply::readyRead, this, [this] {
+        const QByteArray data = m_reply->readAll();
+        m_file->write(data);
+        m_hash->addData(data);
+    });
+    connect(m_reply, &QNetworkReply::downloadProgress, this, [this](qint64 received, qint64 total) {
+        if (total > 0)
+            setProgress(qMin<qint64>(100, 100 * (m_offset + received) / (m_offset + total)));
+    });
+    connect(m_reply, &QNetworkReply::finished, this, &FwupdTransaction::downloadFinished);
+}
+
+void FwupdTransaction::downloadFinished()
+{
+    m_reply->deleteLater();
+    m_file->close();
+    m_file->deleteLater();
+    if (status() == CancelledStatus)
+        return;
+
+    if (m_reply->error() != QNetworkReply::NoError) {
+        qWarning() << "Fwupd Error: Could not download" << m_reply->url() << m_reply->errorString();
+        // What we got is kept to resume from next time, unless it's the range that is wrong
+        if (m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 416)
+            m_file->remove();
+        setStatus(DoneWithErrorStatus);
+        return;
+    }
+
+    if (!checksumMatches(m_hash.data())) {
+        qWarning() << "Fwupd Error: Downloaded firmware has a wrong checksum" << m_reply->url();
+        m_file->remove();
+        setStatus(DoneWithErrorStatus);
+        return;
+    }
+
+    const QString fileName = m_app->cacheFile();
+    QFile::remove(fileName);
+    if (!m_file->rename(fileName)) {
+        qWarning() << "Fwupd Error: Could not move the firmware to" << fileName << m_file->errorString();
+        setStatus(DoneWithErrorStatus);
+        return;
     }
+    fwupdInstall(fileName);
 }
 
 void FwupdTransaction::fwupdInstall(const QString &file)
 {
     FwupdInstallFlags install_flags = FWUPD_INSTALL_FLAG_NONE;
-    g_autoptr(GError) error = nullptr;
 
     /* only offline supported */
     if (m_app->isOnlyOffline())
         install_flags = static_cast<FwupdInstallFlags>(install_flags | FWUPD_INSTALL_FLAG_OFFLINE);
 
-    if (!fwupd_client_install(m_backend->client, m_app->deviceId().toUtf8().constData(), file.toUtf8().constData(), install_flags, nullptr, &error)) {
+    // Interrupting a flash could leave the device unusable
+    setCancellable(false);
+    setStatus(CommittingStatus);
+    setProgress(0);
+    m_percentageHandler = g_signal_connect(m_backend->client, "notify::percentage", G_CALLBACK(&FwupdTransaction::percentageCallback), this);
+    fwupd_client_install_async(m_backend->client,
+                               m_app->deviceId().toUtf8().constData(),
+                               file.toUtf8().constData(),
+                               install_flags,
+                               m_cancellable,
+                               &FwupdTransaction::installCallback,
+                               this);
+}
+
+void FwupdTransaction::installCallback(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    g_autoptr(GError) error = nullptr;
+    const bool successful = fwupd_client_install_finish(FWUPD_CLIENT(source), res, &error);
+    // Only cancelled when the transaction is gone
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        return;
+
+    FwupdTransaction *transaction = static_cast<FwupdTransaction *>(user_data);
+    transaction->installFinished(successful ? nullptr : error);
+}
+
+void FwupdTransaction::percentageCallback(GObject * /*source*/, GParamSpec * /*spec*/, gpointer user_data)
+{
+    static_cast<FwupdTransaction *>(user_data)->updateProgress();
+}
+
+void FwupdTransaction::installFinished(GError *error)
+{
+    g_signal_handler_disconnect(m_backend->client, m_percentageHandler);
+    m_percentageHandler = 0;
+
+    if (error) {
         m_backend->handleError(error);
         setStatus(DoneWithErrorStatus);
     } else
@@ -102,6 +240,8 @@ void FwupdTransaction::proceed()
 void FwupdTransaction::cancel()
 {
     setStatus(CancelledStatus);
+    if (m_reply)
+        m_reply->abort();
 }
 
 void FwupdTransaction::finishTransaction()
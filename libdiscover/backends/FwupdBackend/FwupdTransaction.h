@@ -10,7 +10,10 @@
 
 #include "FwupdBackend.h"
 #include "FwupdResource.h"
+#include <QPointer>
+#include <QSharedPointer>
 #include <Transaction/Transaction.h>
+#include <functional>
 
 class FwupdResource;
 class FwupdTransaction : public Transaction
@@ -29,9 +32,25 @@ private Q_SLOTS:
 
 private:
     void install();
+    void resumeDownload();
+    void download(const QSharedPointer<QCryptographicHash> &hash);
+    void downloadFinished();
+    void hashFile(const QString &fileName, const std::function<void(const QSharedPointer<QCryptographicHash> &)> &callback);
+    bool checksumMatches(QCryptographicHash *hash) const;
+    void installFinished(GError *error);
+    QString partialFile() const;
+
+    static void installCallback(GObject *source, GAsyncResult *res, gpointer user_data);
+    static void percentageCallback(GObject *source, GParamSpec *spec, gpointer user_data);
 
     FwupdResource *const m_app;
     FwupdBackend *const m_backend;
+    GCancellable *const m_cancellable;
+    gulong m_percentageHandler = 0;
+    QPointer<QNetworkReply> m_reply;
+    QFile *m_file = nullptr;
+    QSharedPointer<QCryptographicHash> m_hash;
+    qint64 m_offset = 0;
 };
 
 #endif // FWUPDTRANSACTION_H
@@ -31,9 +31,11 @@
 
 // Own includes
 #include "KNSBackend.h"
+#include "KNSCache.h"
 #include "KNSResource.h"
 #include "KNSReviews.h"
 #include "utils.h"
+#include <DiscoverBackendsFactory.h>
 #include <resources/StandardBackendUpdater.h>
 
 class KNSBackendFactory : public AbstractResourcesBackendFactory
@@ -77,6 +79,26 @@ public:
 
 Q_DECLARE_METATYPE(KNSCore::EntryInternal)
 
+class KNSUpdater : public StandardBackendUpdater
+{
+public:
+    KNSUpdater(KNSBackend *backend)
+        : StandardBackendUpdater(backend)
+        , m_backend(backend)
+    {
+    }
+
+    void prepare() override
+    {
+        // The updates are only known once the engine is up
+        m_backend->initEngineForUpdates();
+        StandardBackendUpdater::prepare();
+    }
+
+private:
+    KNSBackend *const m_backend;
+};
+
 KNSBackend::KNSBackend(QObject *parent, const QString &iconName, const QString &knsrc)
     : AbstractResourcesBackend(parent)
     , m_fetching(false)
@@ -84,7 +106,8 @@ KNSBackend::KNSBackend(QObject *parent, const QString &iconName, const QString &
     , m_reviews(new KNSReviews(this))
     , m_name(knsrc)
     , m_iconName(iconName)
-    , m_updater(new StandardBackendUpdater(this))
+    , m_updater(new KNSUpdater(this))
+    , m_storeCacheTimer(new QTimer(this))
 {
     const QString fileName = QFileInfo(m_name).fileName();
     setName(fileName);
@@ -102,21 +125,10 @@ KNSBackend::KNSBackend(QObject *parent, const QString &iconName, const QString &
     m_extends = group.readEntry("Extends", QStringList());
     m_reviews->setProviderUrl(QUrl(group.readEntry("ProvidersUrl", QString())));
 
-    setFetching(true);
-
     // This ensures we have something to track when checking after the initialization timeout
     connect(this, &KNSBackend::initialized, this, [this]() {
         m_initialized = true;
     });
-    // If we have not initialized in 60 seconds, consider this KNS backend invalid
-    QTimer::singleShot(60000, this, [this]() {
-        if (!m_initialized) {
-            markInvalid(i18n("Backend %1 took too long to initialize", m_displayName));
-            m_responsePending = false;
-            Q_EMIT searchFinished();
-            Q_EMIT availableForQueries();
-        }
-    });
 
     const QVector<QPair<FilterType, QString>> filters = {{CategoryFilter, fileName}};
     const QSet<QString> backendName = {name()};
@@ -150,29 +162,6 @@ KNSBackend::KNSBackend(QObject *parent, const QString &iconName, const QString &
         }
     }
 
-    m_engine = new KNSCore::Engine(this);
-    connect(m_engine, &KNSCore::Engine::signalErrorCode, this, &KNSBackend::signalErrorCode);
-    connect(m_engine, &KNSCore::Engine::signalEntriesLoaded, this, &KNSBackend::receivedEntries, Qt::QueuedConnection);
-    connect(m_engine, &KNSCore::Engine::signalEntryChanged, this, &KNSBackend::statusChanged, Qt::QueuedConnection);
-    connect(m_engine, &KNSCore::Engine::signalEntryDetailsLoaded, this, &KNSBackend::detailsLoaded);
-    connect(m_engine, &KNSCore::Engine::signalProvidersLoaded, this, &KNSBackend::fetchInstalled);
-    connect(m_engine, &KNSCore::Engine::signalUpdateableEntriesLoaded, this, [this] {
-        m_responsePending = false;
-        Q_EMIT availableForQueries();
-    });
-    connect(m_engine, &KNSCore::Engine::signalCategoriesMetadataLoded, this, [categories](const QList<KNSCore::Provider::CategoryMetadata> &categoryMetadatas) {
-        for (const KNSCore::Provider::CategoryMetadata &category : categoryMetadatas) {
-            for (Category *cat : qAsConst(categories)) {
-                if (cat->orFilters().count() > 0 && cat->orFilters().constFirst().second == category.name) {
-                    cat->setName(category.displayName);
-                    break;
-                }
-            }
-        }
-    });
-    m_engine->setPageSize(100);
-    m_engine->init(m_name);
-
     if (m_hasApplications) {
         auto actualCategory = new Category(m_displayName, QStringLiteral("applications-other"), filters, backendName, topCategories, QUrl(), false);
         auto applicationCategory = new Category(i18n("Applications"), //
@@ -185,21 +174,6 @@ KNSBackend::KNSBackend(QObject *parent, const QString &iconName, const QString &
         applicationCategory->setAndFilter({{CategoryFilter, QLatin1String("Application")}});
         m_categories.append(applicationCategory->name());
         m_rootCategories = {applicationCategory};
-        // Make sure we filter out any apps which won't run on the current system architecture
-        QStringList tagFilter = m_engine->tagFilter();
-        if (QSysInfo::currentCpuArchitecture() == QLatin1String("arm")) {
-            tagFilter << QLatin1String("application##architecture==armhf");
-        } else if (QSysInfo::currentCpuArchitecture() == QLatin1String("arm64")) {
-            tagFilter << QLatin1String("application##architecture==arm64");
-        } else if (QSysInfo::currentCpuArchitecture() == QLatin1String("i386")) {
-            tagFilter << QLatin1String("application##architecture==x86");
-        } else if (QSysInfo::currentCpuArchitecture() == QLatin1String("ia64")) {
-            tagFilter << QLatin1String("application##architecture==x86-64");
-        } else if (QSysInfo::currentCpuArchitecture() == QLatin1String("x86_64")) {
-            tagFilter << QLatin1String("application##architecture==x86");
-            tagFilter << QLatin1String("application##architecture==x86-64");
-        }
-        m_engine->setTagFilter(tagFilter);
     } else {
         static const QSet<QString> knsrcPlasma = {
             QStringLiteral("aurorae.knsrc"),       QStringLiteral("icons.knsrc"),
@@ -225,21 +199,137 @@ KNSBackend::KNSBackend(QObject *parent, const QString &iconName, const QString &
         m_rootCategories = {addonsCategory};
     }
 
+    m_providerCategories = categories;
+
+    m_storeCacheTimer->setInterval(5000);
+    m_storeCacheTimer->setSingleShot(true);
+    connect(m_storeCacheTimer, &QTimer::timeout, this, &KNSBackend::storeCache);
+
     connect(m_updater, &StandardBackendUpdater::updatesCountChanged, this, &KNSBackend::updatesCountChanged);
+
+    // The engine is only brought up once we get asked for something, most sessions never get
+    // to the addons. When we're only here for updates we need it right away though.
+    if (DiscoverBackendsFactory::isUpdatesOnly())
+        initEngineForUpdates();
+}
+
+void KNSBackend::initEngineForUpdates()
+{
+    initEngine();
+    // Only show as fetching when the updates are waiting for us, so the updater looks again once we're done
+    if (m_initializing)
+        setFetching(true);
+}
+
+void KNSBackend::initEngine()
+{
+    if (m_engine || !m_isValid)
+        return;
+
+    loadCache();
+    m_initializing = true;
+
+    // If we have not initialized in 60 seconds, consider this KNS backend invalid
+    QTimer::singleShot(60000, this, [this]() {
+        if (!m_initialized) {
+            markInvalid(i18n("Backend %1 took too long to initialize", m_displayName));
+            m_responsePending = false;
+            Q_EMIT searchFinished();
+            Q_EMIT availableForQueries();
+        }
+    });
+
+    m_engine = new KNSCore::Engine(this);
+    connect(m_engine, &KNSCore::Engine::signalErrorCode, this, &KNSBackend::signalErrorCode);
+    connect(m_engine, &KNSCore::Engine::signalEntriesLoaded, this, &KNSBackend::receivedEntries, Qt::QueuedConnection);
+    connect(m_engine, &KNSCore::Engine::signalEntryChanged, this, &KNSBackend::statusChanged, Qt::QueuedConnection);
+    connect(m_engine, &KNSCore::Engine::signalEntryDetailsLoaded, this, &KNSBackend::detailsLoaded);
+    connect(m_engine, &KNSCore::Engine::signalProvidersLoaded, this, &KNSBackend::fetchInstalled);
+    connect(m_engine, &KNSCore::Engine::signalUpdateableEntriesLoaded, this, [this] {
+        m_responsePending = false;
+        Q_EMIT availableForQueries();
+    });
+    connect(m_engine, &KNSCore::Engine::signalCategoriesMetadataLoded, this, [this](const QList<KNSCore::Provider::CategoryMetadata> &categoryMetadatas) {
+        for (const KNSCore::Provider::CategoryMetadata &category : categoryMetadatas) {
+            for (Category *cat : qAsConst(m_providerCategories)) {
+                if (cat->orFilters().count() > 0 && cat->orFilters().constFirst().second == category.name) {
+                    cat->setName(category.displayName);
+                    break;
+                }
+            }
+        }
+    });
+    m_engine->setPageSize(100);
+    m_engine->init(m_name);
+
+    if (m_hasApplications) {
+        // Make sure we filter out any apps which won't run on the current system architecture
+        QStringList tagFilter = m_engine->tagFilter();
+        if (QSysInfo::currentCpuArchitecture() == QLatin1String("arm")) {
+            tagFilter << QLatin1String("application##architecture==armhf");
+        } else if (QSysInfo::currentCpuArchitecture() == QLatin1String("arm64")) {
+            tagFilter << QLatin1String("application##architecture==arm64");
+        } else if (QSysInfo::currentCpuArchitecture() == QLatin1String("i386")) {
+            tagFilter << QLatin1String("application##architecture==x86");
+        } else if (QSysInfo::currentCpuArchitecture() == QLatin1String("ia64")) {
+            tagFilter << QLatin1String("application##architecture==x86-64");
+        } else if (QSysInfo::currentCpuArchitecture() == QLatin1String("x86_64")) {
+            tagFilter << QLatin1String("application##architecture==x86");
+            tagFilter << QLatin1String("application##architecture==x86-64");
+        }
+        m_engine->setTagFilter(tagFilter);
+    }
 }
 
 KNSBackend::~KNSBackend()
 {
+    if (m_storeCacheTimer->isActive())
+        storeCache();
     qDeleteAll(m_rootCategories);
 }
 
+QString KNSBackend::cachePath() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/kns/") + name() + QLatin1String(".xml");
+}
+
+void KNSBackend::loadCache()
+{
+    if (m_cacheLoaded)
+        return;
+    m_cacheLoaded = true;
+
+    const auto cached = KNSCache::load(cachePath());
+    for (const auto &cachedEntry : cached) {
+        resourceForEntry(cachedEntry.entry);
+        m_lastSeen[cachedEntry.entry.uniqueId()] = cachedEntry.lastSeen;
+    }
+    // Nothing new to store
+    m_storeCacheTimer->stop();
+}
+
+void KNSBackend::storeCache()
+{
+    m_storeCacheTimer->stop();
+
+    QVector<KNSCache::Entry> entries;
+    entries.reserve(m_resourcesByName.count());
+    for (auto it = m_resourcesByName.constBegin(), itEnd = m_resourcesByName.constEnd(); it != itEnd; ++it) {
+        entries.append({static_cast<KNSResource *>(*it)->entry(), m_lastSeen.value(it.key())});
+    }
+    KNSCache::store(cachePath(), entries);
+}
+
 void KNSBackend::markInvalid(const QString &message)
 {
     m_rootCategories.clear();
     qWarning() << "invalid kns backend!" << m_name << "because:" << message;
     m_isValid = false;
+    if (m_initializing)
+        finishInitializing();
+    else
+        Q_EMIT initialized();
     setFetching(false);
-    Q_EMIT initialized();
 }
 
 void KNSBackend::fetchInstalled()
@@ -276,6 +366,12 @@ void KNSBackend::fetchInstalled()
 
 void KNSBackend::checkForUpdates()
 {
+    // Initializing the engine already checks for updates
+    if (!m_engine) {
+        initEngineForUpdates();
+        return;
+    }
+
     // Since we load the updates during initialization already, don't overburden
     // the machine with multiple of these, because that would just be silly.
     if (m_initialized) {
@@ -301,10 +397,22 @@ void KNSBackend::setFetching(bool f)
     if (m_fetching != f) {
         m_fetching = f;
         emit fetchingChanged();
+    }
+}
 
-        if (!m_fetching) {
-            Q_EMIT initialized();
-        }
+void KNSBackend::finishInitializing()
+{
+    if (!m_initializing)
+        return;
+
+    m_initializing = false;
+    Q_EMIT initialized();
+    if (m_fetching) {
+        // The updater refreshes when we stop fetching
+        setFetching(false);
+    } else {
+        // Brought up by a search, the updates found meanwhile still need to be listed
+        m_updater->refreshUpdateable();
     }
 }
 
@@ -318,7 +426,7 @@ KNSResource *KNSBackend::resourceForEntry(const KNSCore::EntryInternal &entry)
     KNSResource *r = static_cast<KNSResource *>(m_resourcesByName.value(entry.uniqueId()));
     if (!r) {
         QStringList categories{name(), m_rootCategories.first()->name()};
-        const auto cats = m_engine->categoriesMetadata();
+        const QList<KNSCore::Provider::CategoryMetadata> cats = m_engine ? m_engine->categoriesMetadata() : QList<KNSCore::Provider::CategoryMetadata>{};
         const int catIndex = kIndexOf(cats, [&entry](const KNSCore::Provider::CategoryMetadata &cat) {
             return entry.category() == cat.id;
         });
@@ -333,6 +441,11 @@ KNSResource *KNSBackend::resourceForEntry(const KNSCore::EntryInternal &entry)
     } else {
         r->setEntry(entry);
     }
+    if (m_cacheLoaded) {
+        // Only what the provider offers counts as seen, loadCache() sets when it was for the cached ones
+        m_lastSeen[entry.uniqueId()] = QDateTime::currentDateTimeUtc();
+        m_storeCacheTimer->start();
+    }
     return r;
 }
 
@@ -351,13 +464,13 @@ void KNSBackend::receivedEntries(const KNSCore::EntryInternal::List &entries)
     } else {
         Q_EMIT searchFinished();
         Q_EMIT availableForQueries();
-        setFetching(false);
+        finishInitializing();
         return;
     }
     // qDebug() << "received" << objectName() << this << m_resourcesByName.count();
     if (m_onePage) {
         Q_EMIT availableForQueries();
-        setFetching(false);
+        finishInitializing();
     }
 }
 
@@ -449,8 +562,8 @@ void KNSBackend::signalErrorCode(const KNSCore::ErrorCode &errorCode, const QStr
     m_responsePending = false;
     Q_EMIT searchFinished();
     Q_EMIT availableForQueries();
-    // Setting setFetching to false when we get an error ensures we don't end up in an eternally-fetching state
-    this->setFetching(false);
+    // Finishing the initialization when we get an error ensures we don't end up in an eternally-fetching state
+    finishInitializing();
     qWarning() << "kns error" << objectName() << error;
     if (!invalidFile)
         Q_EMIT passiveMessage(i18n("%1: %2", name(), error));
@@ -564,6 +677,9 @@ ResultsStream *KNSBackend::search(const AbstractResourcesBackend::Filters &filte
     if (filter.resourceUrl.scheme() == QLatin1String("kns")) {
         return findResourceByPackageName(filter.resourceUrl);
     } else if (filter.state >= AbstractResource::Installed) {
+        // What's installed is known from the last session, no need to wait for the provider
+        initEngine();
+        const bool fromCache = !m_resourcesByName.isEmpty();
         auto stream = new ResultsStream(QStringLiteral("KNS-installed"));
 
         const auto start = [this, stream, filter]() {
@@ -579,7 +695,7 @@ ResultsStream *KNSBackend::search(const AbstractResourcesBackend::Filters &filte
             }
             stream->finish();
         };
-        if (isFetching()) {
+        if (m_initializing && !fromCache) {
             connect(this, &KNSBackend::initialized, stream, start);
         } else {
             QTimer::singleShot(0, stream, start);
@@ -600,10 +716,23 @@ ResultsStream *KNSBackend::search(const AbstractResourcesBackend::Filters &filte
 
 void KNSBackend::searchStream(ResultsStream *stream, const QString &searchText)
 {
+    initEngine();
     Q_EMIT startingSearch();
 
+    // Offer what we knew from the last session while the provider catches up
+    if (m_initializing && !m_resourcesByName.isEmpty()) {
+        const auto cached = kFilter<QVector<AbstractResource *>>(m_resourcesByName, [&searchText](AbstractResource *r) {
+            return r->name().contains(searchText, Qt::CaseInsensitive) || r->comment().contains(searchText, Qt::CaseInsensitive);
+        });
+        if (!cached.isEmpty()) {
+            QTimer::singleShot(0, stream, [stream, cached] {
+                Q_EMIT stream->resourcesFound(cached);
+            });
+        }
+    }
+
     auto start = [this, stream, searchText]() {
-        Q_ASSERT(!isFetching());
+        Q_ASSERT(!m_initializing);
         if (!m_isValid) {
             stream->finish();
             return;
@@ -621,7 +750,7 @@ void KNSBackend::searchStream(ResultsStream *stream, const QString &searchText)
 
     if (m_responsePending) {
         connect(this, &KNSBackend::availableForQueries, stream, start, Qt::QueuedConnection);
-    } else if (isFetching()) {
+    } else if (m_initializing) {
         connect(this, &KNSBackend::initialized, stream, start);
     } else {
         QTimer::singleShot(0, stream, start);
@@ -658,8 +787,11 @@ ResultsStream *KNSBackend::findResourceByPackageName(const QUrl &search)
             stream->finish();
         });
     };
+    initEngine();
     if (m_responsePending) {
         connect(this, &KNSBackend::availableForQueries, stream, start);
+    } else if (m_initializing) {
+        connect(this, &KNSBackend::initialized, stream, start);
     } else {
         start();
     }
@@ -9,11 +9,13 @@
 
 #include <KNSCore/EntryInternal>
 #include <KNSCore/ErrorCode>
+#include <QDateTime>
 
 #include "Transaction/AddonList.h"
 #include "discovercommon_export.h"
 #include <resources/AbstractResourcesBackend.h>
 
+class QTimer;
 class KNSReviews;
 class KNSResource;
 class StandardBackendUpdater;
@@ -68,6 +70,9 @@ public:
 
     void checkForUpdates() override;
 
+    /// Brings the engine up if it isn't yet, showing as fetching until the updates are known
+    void initEngineForUpdates();
+
     QString displayName() const override;
 
 Q_SIGNALS:
@@ -90,12 +95,17 @@ private:
     void markInvalid(const QString &message);
     void searchStream(ResultsStream *stream, const QString &searchText);
     void fetchMore();
+    void initEngine();
+    void finishInitializing();
+    QString cachePath() const;
+    void loadCache();
+    void storeCache();
 
     bool m_onePage = false;
     bool m_responsePending = false;
     bool m_fetching;
     bool m_isValid;
-    KNSCore::Engine *m_engine;
+    KNSCore::Engine *m_engine = nullptr;
     QHash<QString, AbstractResource *> m_resourcesByName;
     KNSReviews *const m_reviews;
     QString m_name;
@@ -104,9 +114,17 @@ private:
     QStringList m_extends;
     QStringList m_categories;
     QVector<Category *> m_rootCategories;
+    /// categories offered by the provider, named after its metadata once it's loaded
+    QVector<Category *> m_providerCategories;
     QString m_displayName;
     bool m_initialized = false;
+    /// the engine is up but still loading the installed and updateable entries
+    bool m_initializing = false;
     bool m_hasApplications = false;
+    bool m_cacheLoaded = false;
+    /// when the provider offered each entry last
+    QHash<QString, QDateTime> m_lastSeen;
+    QTimer *const m_storeCacheTimer;
 };
 
 #endif // KNSBACKEND_H
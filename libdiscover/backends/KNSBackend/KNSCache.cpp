@@ -0,0 +1,81 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "KNSCache.h"
+#include <QDebug>
+#include <QDir>
+#include <QDomDocument>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <iterator>
+
+const int KNSCache::maxAge = 14;
+const int KNSCache::maxEntries = 1000;
+
+static const QString s_lastSeenAttribute = QStringLiteral("discover-last-seen");
+
+QVector<KNSCache::Entry> KNSCache::load(const QString &path, const QDateTime &now)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    QDomDocument doc;
+    if (!doc.setContent(&file)) {
+        qWarning() << "could not parse the kns cache" << path;
+        return {};
+    }
+
+    QVector<Entry> ret;
+    const QDateTime oldest = now.addDays(-maxAge);
+    const QDomElement root = doc.documentElement();
+    for (QDomElement element = root.firstChildElement(QStringLiteral("stuff")); !element.isNull(); element = element.nextSiblingElement(QStringLiteral("stuff"))) {
+        const QDateTime lastSeen = QDateTime::fromSecsSinceEpoch(element.attribute(s_lastSeenAttribute).toLongLong(), Qt::UTC);
+        if (lastSeen < oldest)
+            continue;
+
+        Entry entry;
+        entry.lastSeen = lastSeen;
+        if (entry.entry.setEntryXML(element) && entry.entry.isValid())
+            ret += entry;
+    }
+    return ret;
+}
+
+bool KNSCache::store(const QString &path, const QVector<Entry> &entries, const QDateTime &now)
+{
+    QVector<Entry> kept;
+    const QDateTime oldest = now.addDays(-maxAge);
+    std::copy_if(entries.constBegin(), entries.constEnd(), std::back_inserter(kept), [&oldest](const Entry &entry) {
+        return entry.lastSeen >= oldest;
+    });
+    if (kept.count() > maxEntries) {
+        std::sort(kept.begin(), kept.end(), [](const Entry &a, const Entry &b) {
+            return a.lastSeen > b.lastSeen;
+        });
+        kept.resize(maxEntries);
+    }
+
+    QDomDocument doc;
+    QDomElement root = doc.createElement(QStringLiteral("knscache"));
+    doc.appendChild(root);
+    for (const Entry &entry : qAsConst(kept)) {
+        QDomElement element = doc.importNode(entry.entry.entryXML(), true).toElement();
+        element.setAttribute(s_lastSeenAttribute, QString::number(entry.lastSeen.toSecsSinceEpoch()));
+        root.appendChild(element);
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "could not open the kns cache" << path << file.errorString();
+        return false;
+    }
+    file.write(doc.toByteArray());
+    return file.commit();
+}
@@ -0,0 +1,42 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#ifndef KNSCACHE_H
+#define KNSCACHE_H
+
+#include <KNSCore/EntryInternal>
+#include <QDateTime>
+#include <QVector>
+
+/**
+ * Keeps the entries a provider offered on disk, so they can be shown on the next run
+ * before the provider answers.
+ *
+ * Every entry remembers when the provider offered it last. The ones it stopped offering
+ * are likely withdrawn and get dropped after a while, and only the ones offered last are
+ * kept when there are too many.
+ */
+class KNSCache
+{
+public:
+    struct Entry {
+        KNSCore::EntryInternal entry;
+        QDateTime lastSeen;
+    };
+
+    /// Days an entry is kept after the provider offered it last
+    static const int maxAge;
+    /// How many entries are kept at most
+    static const int maxEntries;
+
+    /// @returns the entries stored in @p path that are still recent enough by @p now
+    static QVector<Entry> load(const QString &path, const QDateTime &now = QDateTime::currentDateTimeUtc());
+
+    /// Stores @p entries in @p path, leaving out the ones that are too old by @p now
+    static bool store(const QString &path, const QVector<Entry> &entries, const QDateTime &now = QDateTime::currentDateTimeUtc());
+};
+
+#endif // KNSCACHE_H
@@ -10,6 +10,8 @@
 #include <Category/CategoryModel.h>
 #include <DiscoverBackendsFactory.h>
 #include <KNSBackend.h>
+#include <KNSCache.h>
+#include <QFile>
 #include <QStandardPaths>
 #include <ReviewsBackend/AbstractReviewsBackend.h>
 #include <ReviewsBackend/Rating.h>
@@ -164,3 +166,51 @@ void KNSBackendTest::testResourceByUrlResourcesModel()
     });
     QCOMPARE(res.count(), 0);
 }
+
+void KNSBackendTest::testCache()
+{
+    const QString path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/kns-test.xml");
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+
+    const auto makeEntry = [](const QString &id, const QDateTime &lastSeen) {
+        KNSCache::Entry ret;
+        ret.entry.setUniqueId(id);
+        ret.entry.setName(QLatin1String("Name of ") + id);
+        ret.entry.setProviderId(QStringLiteral("https://example.org/ocs/providers.xml"));
+        ret.lastSeen = lastSeen.addMSecs(-lastSeen.time().msec());
+        return ret;
+    };
+
+    QVector<KNSCache::Entry> entries = {
+        makeEntry(QStringLiteral("recent"), now.addSecs(-60)),
+        makeEntry(QStringLiteral("older"), now.addDays(-KNSCache::maxAge + 1)),
+        makeEntry(QStringLiteral("withdrawn"), now.addDays(-KNSCache::maxAge - 1)),
+    };
+    QVERIFY(KNSCache::store(path, entries, now));
+
+    // The ones not offered for too long are gone
+    auto loaded = KNSCache::load(path, now);
+    QCOMPARE(loaded.count(), 2);
+    QCOMPARE(loaded[0].entry.uniqueId(), QStringLiteral("recent"));
+    QCOMPARE(loaded[0].entry.name(), QStringLiteral("Name of recent"));
+    QCOMPARE(loaded[0].entry.providerId(), entries[0].entry.providerId());
+    QCOMPARE(loaded[0].lastSeen, entries[0].lastSeen);
+    QCOMPARE(loaded[1].entry.uniqueId(), QStringLiteral("older"));
+
+    // Time goes by and the older one expires too
+    QCOMPARE(KNSCache::load(path, now.addDays(2)).count(), 1);
+
+    // Only the ones offered last are kept when there are too many
+    entries.clear();
+    for (int i = 0; i < KNSCache::maxEntries + 10; ++i) {
+        entries += makeEntry(QString::number(i), now.addSecs(-i));
+    }
+    QVERIFY(KNSCache::store(path, entries, now));
+    loaded = KNSCache::load(path, now);
+    QCOMPARE(loaded.count(), KNSCache::maxEntries);
+    for (const auto &entry : qAsConst(loaded)) {
+        QVERIFY(entry.entry.uniqueId().toInt() < KNSCache::maxEntries);
+    }
+
+    QFile::remove(path);
+}
@@ -26,6 +26,7 @@ private Q_SLOTS:
     void testReviews();
     void testResourceByUrl();
     void testResourceByUrlResourcesModel();
+    void testCache();
 
 public Q_SLOTS:
     void reviewsArrived(AbstractResource *r, const QVector<ReviewPtr> &revs);
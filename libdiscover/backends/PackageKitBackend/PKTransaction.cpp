@@ -19,15 +19,23 @@
 #include <functional>
 #include <resources/AbstractResource.h>
 
+static QSet<QString> packageNames(const QVector<AbstractResource *> &apps)
+{
+    QSet<QString> ret;
+    for (auto r : apps) {
+        PackageKitResource *res = qobject_cast<PackageKitResource *>(r);
+        ret.unite(kToSet(res->allPackageNames()));
+    }
+    return ret;
+}
+
 PKTransaction::PKTransaction(const QVector<AbstractResource *> &apps, Transaction::Role role)
     : Transaction(apps.first(), apps.first(), role)
     , m_apps(apps)
+    , m_requestedApps(apps)
 {
     Q_ASSERT(!apps.contains(nullptr));
-    foreach (auto r, apps) {
-        PackageKitResource *res = qobject_cast<PackageKitResource *>(r);
-        m_pkgnames.unite(kToSet(res->allPackageNames()));
-    }
+    m_pkgnames = packageNames(apps);
 
     QTimer::singleShot(0, this, &PKTransaction::start);
 }
@@ -42,8 +50,39 @@ static QStringList packageIds(const QVector<AbstractResource *> &res, std::funct
     return ret;
 }
 
+bool PKTransaction::isLocalFile() const
+{
+    return m_apps.size() == 1 && qobject_cast<LocalFilePKResource *>(m_apps.at(0));
+}
+
+QStringList PKTransaction::installPackageIds() const
+{
+    return packageIds(m_apps, [](PackageKitResource *r) {
+        return r->availablePackageId();
+    });
+}
+
 void PKTransaction::start()
 {
+    if (!m_queued && role() == Transaction::InstallRole && !isLocalFile()) {
+        // Wait a bit for other installations to do them all at once, see startBatch()
+        m_queued = true;
+        setStatus(Transaction::QueuedStatus);
+        qobject_cast<PackageKitBackend *>(resource()->backend())->queueInstall(this);
+        return;
+    }
+
+    if ((role() == Transaction::InstallRole || role() == Transaction::ChangeAddonsRole) && !isLocalFile()) {
+        // Usually simulated already while the user was looking at the application
+        const auto backend = qobject_cast<PackageKitBackend *>(resource()->backend());
+        if (const auto simulation = backend->cachedSimulation(installPackageIds())) {
+            m_newPackageStates = simulation->packages;
+            m_packageSummaries = simulation->summaries;
+            reviewSimulation();
+            return;
+        }
+    }
+
     trigger(PackageKit::Transaction::TransactionFlagSimulate);
 }
 
@@ -52,8 +91,9 @@ void PKTransaction::trigger(PackageKit::Transaction::TransactionFlags flags)
     if (m_trans)
         m_trans->deleteLater();
     m_newPackageStates.clear();
+    m_packageSummaries.clear();
 
-    if (m_apps.size() == 1 && qobject_cast<LocalFilePKResource *>(m_apps.at(0))) {
+    if (isLocalFile()) {
         auto app = qobject_cast<LocalFilePKResource *>(m_apps.at(0));
         m_trans = PackageKit::Daemon::installFile(QUrl(app->packageName()).toLocalFile(), flags);
         connect(m_trans.data(), &PackageKit::Transaction::finished, this, [this, app](PackageKit::Transaction::Exit status) {
@@ -66,9 +106,7 @@ void PKTransaction::trigger(PackageKit::Transaction::TransactionFlags flags)
         switch (role()) {
         case Transaction::ChangeAddonsRole:
         case Transaction::InstallRole: {
-            const QStringList ids = packageIds(m_apps, [](PackageKitResource *r) {
-                return r->availablePackageId();
-            });
+            const QStringList ids = installPackageIds();
             if (ids.isEmpty()) {
                 // FIXME this state shouldn't exist
                 qWarning() << "Installing no packages found!";
@@ -103,6 +141,7 @@ void PKTransaction::trigger(PackageKit::Transaction::TransactionFlags flags)
     connect(m_trans.data(), &PackageKit::Transaction::requireRestart, this, &PKTransaction::requireRestart);
     connect(m_trans.data(), &PackageKit::Transaction::repoSignatureRequired, this, &PKTransaction::repoSignatureRequired);
     connect(m_trans.data(), &PackageKit::Transaction::percentageChanged, this, &PKTransaction::progressChanged);
+    connect(m_trans.data(), &PackageKit::Transaction::itemProgress, this, &PKTransaction::itemProgress);
     connect(m_trans.data(), &PackageKit::Transaction::statusChanged, this, &PKTransaction::statusChanged);
     connect(m_trans.data(), &PackageKit::Transaction::eulaRequired, this, &PKTransaction::eulaRequired);
     connect(m_trans.data(), &PackageKit::Transaction::allowCancelChanged, this, &PKTransaction::cancellableChanged);
@@ -116,6 +155,78 @@ void PKTransaction::trigger(PackageKit::Transaction::TransactionFlags flags)
     setCancellable(m_trans->allowCancel());
 }
 
+void PKTransaction::startBatch(const QVector<PKTransaction *> &followers)
+{
+    for (const auto &packageId : installPackageIds()) {
+        m_itemOwners.insert(packageId, this);
+    }
+
+    for (PKTransaction *follower : followers) {
+        for (const auto &packageId : follower->installPackageIds()) {
+            m_itemOwners.insert(packageId, follower);
+        }
+        m_apps += follower->m_apps;
+        m_pkgnames.unite(follower->m_pkgnames);
+        m_followers += follower;
+        follower->m_leader = this;
+
+        // The outcome is decided per resource, see cleanup()
+        connect(this, &Transaction::statusChanged, follower, [follower](Transaction::Status status) {
+            if (status < Transaction::DoneStatus)
+                follower->setStatus(status);
+        });
+        connect(this, &Transaction::cancellableChanged, follower, &Transaction::setCancellable);
+        connect(this, &Transaction::downloadSpeedChanged, follower, &Transaction::setDownloadSpeed);
+        connect(this, &Transaction::remainingTimeChanged, follower, &Transaction::setRemainingTime);
+    }
+    start();
+}
+
+QVector<PKTransaction *> PKTransaction::batchMembers() const
+{
+    QVector<PKTransaction *> ret = {const_cast<PKTransaction *>(this)};
+    for (const auto &follower : m_followers) {
+        if (follower)
+            ret += follower;
+    }
+    return ret;
+}
+
+void PKTransaction::dissolveBatch()
+{
+    for (const auto &follower : qAsConst(m_followers)) {
+        if (follower) {
+            disconnect(this, nullptr, follower, nullptr);
+            follower->m_leader = nullptr;
+        }
+    }
+    m_followers.clear();
+    m_itemOwners.clear();
+    m_itemProgress.clear();
+    m_proceedFunctions.clear();
+    m_apps = m_requestedApps;
+    m_pkgnames = packageNames(m_apps);
+
+    if (m_trans) {
+        disconnect(m_trans, nullptr, this, nullptr);
+        if (m_trans->allowCancel())
+            m_trans->cancel();
+        m_trans = nullptr;
+    }
+}
+
+void PKTransaction::startMembers(const QVector<PKTransaction *> &members)
+{
+    if (members.isEmpty())
+        return;
+
+    auto leader = members.first();
+    if (members.size() == 1)
+        leader->start();
+    else
+        leader->startBatch(members.mid(1));
+}
+
 void PKTransaction::statusChanged()
 {
     setStatus(m_trans->status() == PackageKit::Transaction::StatusDownload ? Transaction::DownloadingStatus : Transaction::CommittingStatus);
@@ -131,8 +242,29 @@ void PKTransaction::progressChanged()
     }
 
     const auto processedPercentage = percentageWithStatus(m_trans->status(), qBound<int>(0, percent, 100));
-    if (processedPercentage >= 0)
+    if (processedPercentage < 0)
+        return;
+
+    // Resources whose packages report their own progress keep it, the rest follow the whole transaction
+    if (!m_itemProgress.contains(this))
         setProgress(processedPercentage);
+    for (const auto &follower : qAsConst(m_followers)) {
+        if (follower && !m_itemProgress.contains(follower))
+            follower->setProgress(processedPercentage);
+    }
+}
+
+void PKTransaction::itemProgress(const QString &packageId, PackageKit::Transaction::Status status, uint percentage)
+{
+    PKTransaction *owner = m_itemOwners.value(packageId);
+    if (!owner)
+        return;
+
+    const auto processedPercentage = percentageWithStatus(status, qMin<uint>(percentage, 100));
+    if (processedPercentage >= 0) {
+        m_itemProgress.insert(owner);
+        owner->setProgress(processedPercentage);
+    }
 }
 
 void PKTransaction::cancellableChanged()
@@ -142,7 +274,20 @@ void PKTransaction::cancellableChanged()
 
 void PKTransaction::cancel()
 {
-    if (!m_trans) {
+    PKTransaction *leader = m_leader ? m_leader.data() : this;
+    auto members = leader->batchMembers();
+    if (members.size() > 1) {
+        if (leader->m_trans && !leader->m_trans->allowCancel()) {
+            qWarning() << "trying to cancel a non-cancellable transaction: " << resource()->name();
+            return;
+        }
+
+        // Only our resources leave the batch, the others start over without them
+        members.removeAll(this);
+        leader->dissolveBatch();
+        setStatus(CancelledStatus);
+        startMembers(members);
+    } else if (!m_trans) {
         setStatus(CancelledStatus);
     } else if (m_trans->allowCancel()) {
         m_trans->cancel();
@@ -161,51 +306,70 @@ void PKTransaction::cleanup(PackageKit::Transaction::Exit exit, uint runtime)
     disconnect(m_trans, nullptr, this, nullptr);
     m_trans = nullptr;
 
-    const auto backend = qobject_cast<PackageKitBackend *>(resource()->backend());
-
     if (!cancel && !failed && simulate) {
-        auto packagesToRemove = m_newPackageStates.value(PackageKit::Transaction::InfoRemoving);
-        QMutableListIterator<QString> i(packagesToRemove);
-        QSet<AbstractResource *> removedResources;
-        while (i.hasNext()) {
-            const auto pkgname = PackageKit::Daemon::packageName(i.next());
-            removedResources.unite(backend->resourcesByPackageName(pkgname));
-
-            if (m_pkgnames.contains(pkgname)) {
-                i.remove();
-            }
+        if ((role() == Transaction::InstallRole || role() == Transaction::ChangeAddonsRole) && !isLocalFile()) {
+            const auto backend = qobject_cast<PackageKitBackend *>(resource()->backend());
+            backend->storeSimulation(installPackageIds(), {m_newPackageStates, m_packageSummaries});
         }
-        removedResources.subtract(kToSet(m_apps));
-
-        if (!packagesToRemove.isEmpty() || !removedResources.isEmpty()) {
-            QString msg = QLatin1String("<ul><li>") + PackageKitResource::joinPackages(packagesToRemove, QLatin1String("</li><li>"), {});
-            if (!removedResources.isEmpty()) {
-                const QStringList removedResourcesStr = kTransform<QStringList>(removedResources, [](AbstractResource *a) {
-                    return a->name();
-                });
-                msg += QLatin1Char('\n');
-                msg += removedResourcesStr.join(QLatin1String("</li><li>"));
-            }
-            msg += QStringLiteral("</li></ul>");
+        reviewSimulation();
+        return;
+    }
 
-            Q_EMIT proceedRequest(i18n("Confirm package removal"),
-                                  i18np("This action will also remove the following package:\n%2",
-                                        "This action will also remove the following packages:\n%2",
-                                        packagesToRemove.count(),
-                                        msg));
-        } else {
-            proceed();
-        }
+    const auto members = batchMembers();
+    if (failed && members.size() > 1) {
+        // We can't tell which of the resources broke it, find out by installing them one by one
+        qCDebug(LIBDISCOVER_BACKEND_LOG) << "batch failed, retrying its" << members.size() << "resources separately";
+        dissolveBatch();
+        for (auto member : members)
+            member->start();
         return;
     }
 
     this->submitResolve();
+    Transaction::Status status = Transaction::DoneStatus;
     if (failed)
-        setStatus(Transaction::DoneWithErrorStatus);
+        status = Transaction::DoneWithErrorStatus;
     else if (cancel)
-        setStatus(Transaction::CancelledStatus);
-    else
-        setStatus(Transaction::DoneStatus);
+        status = Transaction::CancelledStatus;
+    for (auto member : members)
+        member->setStatus(status);
+}
+
+void PKTransaction::reviewSimulation()
+{
+    const auto backend = qobject_cast<PackageKitBackend *>(resource()->backend());
+    auto packagesToRemove = m_newPackageStates.value(PackageKit::Transaction::InfoRemoving);
+    QMutableListIterator<QString> i(packagesToRemove);
+    QSet<AbstractResource *> removedResources;
+    while (i.hasNext()) {
+        const auto pkgname = PackageKit::Daemon::packageName(i.next());
+        removedResources.unite(backend->resourcesByPackageName(pkgname));
+
+        if (m_pkgnames.contains(pkgname)) {
+            i.remove();
+        }
+    }
+    removedResources.subtract(kToSet(m_apps));
+
+    if (!packagesToRemove.isEmpty() || !removedResources.isEmpty()) {
+        QString msg = QLatin1String("<ul><li>") + PackageKitResource::joinPackages(packagesToRemove, QLatin1String("</li><li>"), {});
+        if (!removedResources.isEmpty()) {
+            const QStringList removedResourcesStr = kTransform<QStringList>(removedResources, [](AbstractResource *a) {
+                return a->name();
+            });
+            msg += QLatin1Char('\n');
+            msg += removedResourcesStr.join(QLatin1String("</li><li>"));
+        }
+        msg += QStringLiteral("</li></ul>");
+
+        Q_EMIT proceedRequest(i18n("Confirm package removal"),
+                              i18np("This action will also remove the following package:\n%2",
+                                    "This action will also remove the following packages:\n%2",
+                                    packagesToRemove.count(),
+                                    msg));
+    } else {
+        proceed();
+    }
 }
 
 void PKTransaction::processProceedFunction()
@@ -231,7 +395,7 @@ void PKTransaction::proceed()
     if (!m_proceedFunctions.isEmpty()) {
         processProceedFunction();
     } else {
-        if (m_apps.size() == 1 && qobject_cast<LocalFilePKResource *>(m_apps.at(0))) {
+        if (isLocalFile()) {
             trigger(PackageKit::Transaction::TransactionFlagNone);
         } else {
             trigger(PackageKit::Transaction::TransactionFlagOnlyTrusted);
@@ -239,9 +403,10 @@ void PKTransaction::proceed()
     }
 }
 
-void PKTransaction::packageResolved(PackageKit::Transaction::Info info, const QString &packageId)
+void PKTransaction::packageResolved(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary)
 {
     m_newPackageStates[info].append(packageId);
+    m_packageSummaries.insert(packageId, summary);
 }
 
 void PKTransaction::submitResolve()
@@ -292,6 +457,11 @@ void PKTransaction::errorFound(PackageKit::Transaction::Error err, const QString
 {
     if (err == PackageKit::Transaction::ErrorNoLicenseAgreement || err == PackageKit::Transaction::ErrorTransactionCancelled)
         return;
+    if (batchMembers().size() > 1) {
+        // Reported once the resource that caused it is retried on its own
+        qCDebug(LIBDISCOVER_BACKEND_LOG) << "PackageKit batch error:" << err << error;
+        return;
+    }
     qWarning() << "PackageKit error:" << err << PackageKitMessages::errorMessage(err) << error;
     Q_EMIT passiveMessage(PackageKitMessages::errorMessage(err));
 }
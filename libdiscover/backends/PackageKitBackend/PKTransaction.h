@@ -22,6 +22,14 @@ public:
     void cancel() override;
     void proceed() override;
 
+    /**
+     * Installs the resources of @p followers along with ours in a single PackageKit transaction.
+     *
+     * The followers report the progress of their own packages. If the batch fails, every resource is
+     * retried on its own so that only the ones that can't be installed end up with an error.
+     */
+    void startBatch(const QVector<PKTransaction *> &followers);
+
 public Q_SLOTS:
     void start();
 
@@ -34,9 +42,13 @@ private:
     void mediaChange(PackageKit::Transaction::MediaType media, const QString &type, const QString &text);
     void requireRestart(PackageKit::Transaction::Restart restart, const QString &p);
     void progressChanged();
+    void itemProgress(const QString &packageId, PackageKit::Transaction::Status status, uint percentage);
     void eulaRequired(const QString &eulaID, const QString &packageID, const QString &vendor, const QString &licenseAgreement);
     void cancellableChanged();
-    void packageResolved(PackageKit::Transaction::Info info, const QString &packageId);
+    void packageResolved(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary);
+    void reviewSimulation();
+    bool isLocalFile() const;
+    QStringList installPackageIds() const;
     void submitResolve();
     void repoSignatureRequired(const QString &packageID,
                                const QString &repoName,
@@ -48,12 +60,24 @@ private:
                                PackageKit::Transaction::SigType type);
 
     void trigger(PackageKit::Transaction::TransactionFlags flags);
+    QVector<PKTransaction *> batchMembers() const;
+    void dissolveBatch();
+    static void startMembers(const QVector<PKTransaction *> &members);
+
     QPointer<PackageKit::Transaction> m_trans;
-    const QVector<AbstractResource *> m_apps;
+    QVector<AbstractResource *> m_apps;
+    /// The resources we were created for, m_apps also has the ones of our followers
+    const QVector<AbstractResource *> m_requestedApps;
+    bool m_queued = false;
+    QPointer<PKTransaction> m_leader;
+    QVector<QPointer<PKTransaction>> m_followers;
+    QHash<QString, QPointer<PKTransaction>> m_itemOwners;
+    QSet<PKTransaction *> m_itemProgress;
     QSet<QString> m_pkgnames;
     QVector<std::function<PackageKit::Transaction *()>> m_proceedFunctions;
 
     QMap<PackageKit::Transaction::Info, QStringList> m_newPackageStates;
+    QHash<QString, QString> m_packageSummaries;
 };
 
 #endif // PKTRANSACTION_H
@@ -11,7 +11,9 @@
 #include "PKResolveTransaction.h"
 #include "PKTransaction.h"
 #include "PackageKitSourcesBackend.h"
+#include "PackageKitUpdatesCache.h"
 #include "PackageKitUpdater.h"
+#include <DiscoverBackendsFactory.h>
 #include <appstream/AppStreamIntegration.h>
 #include <appstream/AppStreamUtils.h>
 #include <appstream/OdrsReviewsBackend.h>
@@ -19,6 +21,7 @@
 #include <resources/SourcesModel.h>
 #include <resources/StandardBackendUpdater.h>
 
+#include <QDateTime>
 #include <QDebug>
 #include <QFile>
 #include <QFileSystemWatcher>
@@ -64,7 +67,7 @@ PackageKitBackend::PackageKitBackend(QObject *parent)
     , m_updater(new PackageKitUpdater(this))
     , m_refresher(nullptr)
     , m_isFetching(0)
-    , m_reviews(AppStreamIntegration::global()->reviews())
+    , m_reviews(DiscoverBackendsFactory::isUpdatesOnly() ? QSharedPointer<OdrsReviewsBackend>() : AppStreamIntegration::global()->reviews())
 {
     QTimer *t = new QTimer(this);
     connect(t, &QTimer::timeout, this, &PackageKitBackend::checkForUpdates);
@@ -76,13 +79,20 @@ PackageKitBackend::PackageKitBackend(QObject *parent)
     m_delayedDetailsFetch.setInterval(100);
     connect(&m_delayedDetailsFetch, &QTimer::timeout, this, &PackageKitBackend::performDetailsFetch);
 
+    // Short enough not to be noticed, long enough to catch installing several search results
+    m_installQueueTimer.setSingleShot(true);
+    m_installQueueTimer.setInterval(300);
+    connect(&m_installQueueTimer, &QTimer::timeout, this, &PackageKitBackend::flushInstallQueue);
+
     connect(PackageKit::Daemon::global(), &PackageKit::Daemon::restartScheduled, m_updater, &PackageKitUpdater::enableNeedsReboot);
     connect(PackageKit::Daemon::global(), &PackageKit::Daemon::isRunningChanged, this, &PackageKitBackend::checkDaemonRunning);
-    connect(m_reviews.data(), &OdrsReviewsBackend::ratingsReady, this, [this] {
-        m_reviews->emitRatingFetched(this, kTransform<QList<AbstractResource *>>(m_packages.packages, [](AbstractResource *r) {
-                                         return r;
-                                     }));
-    });
+    if (m_reviews) {
+        connect(m_reviews.data(), &OdrsReviewsBackend::ratingsReady, this, [this] {
+            m_reviews->emitRatingFetched(this, kTransform<QList<AbstractResource *>>(m_packages.packages, [](AbstractResource *r) {
+                                             return r;
+                                         }));
+        });
+    }
 
     auto proxyWatch = new QFileSystemWatcher(this);
     proxyWatch->addPath(QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + QLatin1String("/kioslaverc"));
@@ -99,6 +109,7 @@ PackageKitBackend::PackageKitBackend(QObject *parent)
     setWhenAvailable(
         PackageKit::Daemon::getTimeSinceAction(PackageKit::Transaction::RoleRefreshCache),
         [this](uint timeSince) {
+            m_lastRefresh = QDateTime::currentSecsSinceEpoch() - timeSince;
             if (timeSince > 3600)
                 checkForUpdates();
             else
@@ -192,11 +203,21 @@ static DelayedAppStreamLoad loadAppStream(AppStream::Pool *appdata)
 
 void PackageKitBackend::reloadPackageList()
 {
-    acquireFetching(true);
     if (m_refresher) {
         disconnect(m_refresher.data(), &PackageKit::Transaction::finished, this, &PackageKitBackend::reloadPackageList);
     }
 
+    // Updates are listed straight from PackageKit, no need to wait for the AppStream catalog
+    if (DiscoverBackendsFactory::isUpdatesOnly()) {
+        if (!m_appstreamInitialized) {
+            m_appstreamInitialized = true;
+            Q_EMIT loadedAppStream();
+        }
+        return;
+    }
+
+    acquireFetching(true);
+
     m_appdata.reset(new AppStream::Pool);
 
     auto fw = new QFutureWatcher<DelayedAppStreamLoad>(this);
@@ -270,8 +291,23 @@ void PackageKitBackend::fetchUpdates()
     if (m_updater->isProgressing())
         return;
 
+    m_updatesToPublish.clear();
+
+    // The notifier might have just asked for the same
+    QVector<UpdatesCache::Update> published;
+    if (loadPackageKitUpdates(m_lastRefresh, &published)) {
+        m_updatesPackageId.clear();
+        m_hasSecurityUpdates = false;
+        for (const auto &update : qAsConst(published))
+            addPackageToUpdate(PackageKit::Transaction::Info(update.info), update.id, update.summary);
+        getUpdatesFinished(PackageKit::Transaction::ExitSuccess, true);
+        return;
+    }
+
     m_getUpdatesTransaction = PackageKit::Daemon::getUpdates();
-    connect(m_getUpdatesTransaction, &PackageKit::Transaction::finished, this, &PackageKitBackend::getUpdatesFinished);
+    connect(m_getUpdatesTransaction, &PackageKit::Transaction::finished, this, [this](PackageKit::Transaction::Exit exit) {
+        getUpdatesFinished(exit, false);
+    });
     connect(m_getUpdatesTransaction, &PackageKit::Transaction::package, this, &PackageKitBackend::addPackageToUpdate);
     connect(m_getUpdatesTransaction, &PackageKit::Transaction::errorCode, this, &PackageKitBackend::transactionError);
     connect(m_getUpdatesTransaction, &PackageKit::Transaction::percentageChanged, this, &PackageKitBackend::fetchingUpdatesProgressChanged);
@@ -293,6 +329,77 @@ void PackageKitBackend::addPackageNotArch(PackageKit::Transaction::Info info, co
     addPackage(info, packageId, summary, false);
 }
 
+static QString simulationKey(QStringList packageIds)
+{
+    packageIds.sort();
+    return packageIds.join(QLatin1Char(';'));
+}
+
+void PackageKitBackend::simulateInstall(const QStringList &packageIds, QObject *context, const std::function<void(const PackageKitSimulation &)> &callback)
+{
+    if (const auto simulation = cachedSimulation(packageIds)) {
+        QTimer::singleShot(0, context, [callback, simulation = *simulation] {
+            callback(simulation);
+        });
+        return;
+    }
+
+    const QString key = simulationKey(packageIds);
+    auto it = m_pendingSimulations.find(key);
+    if (it != m_pendingSimulations.end()) {
+        it->append({context, callback});
+        return;
+    }
+    m_pendingSimulations.insert(key, {{context, callback}});
+
+    auto simulation = QSharedPointer<PackageKitSimulation>::create();
+    auto trans = PackageKit::Daemon::installPackages(packageIds, PackageKit::Transaction::TransactionFlagSimulate);
+    connect(trans, &PackageKit::Transaction::package, this, [simulation](PackageKit::Transaction::Info info, const QString &packageId, const QString &summary) {
+        simulation->packages[info].append(packageId);
+        simulation->summaries.insert(packageId, summary);
+    });
+    connect(trans, &PackageKit::Transaction::finished, this, [this, key, packageIds, simulation](PackageKit::Transaction::Exit exit) {
+        const auto waiting = m_pendingSimulations.take(key);
+        if (exit != PackageKit::Transaction::ExitSuccess) {
+            // Still let everyone waiting know, so they can find out some other way
+            qCDebug(LIBDISCOVER_BACKEND_LOG) << "could not simulate installing" << packageIds << exit;
+            *simulation = {};
+            simulation->success = false;
+        } else {
+            storeSimulation(packageIds, *simulation);
+        }
+
+        for (const auto &request : waiting) {
+            if (request.first)
+                request.second(*simulation);
+        }
+    });
+}
+
+const PackageKitSimulation *PackageKitBackend::cachedSimulation(const QStringList &packageIds) const
+{
+    // Whatever changes the system or refreshes the repositories can change the outcome
+    const QString state = packageKitUpdatesState(m_lastRefresh);
+    if (state.isEmpty() || state != m_simulationsState)
+        return nullptr;
+
+    const auto it = m_simulations.constFind(simulationKey(packageIds));
+    return it == m_simulations.constEnd() ? nullptr : &*it;
+}
+
+void PackageKitBackend::storeSimulation(const QStringList &packageIds, const PackageKitSimulation &simulation)
+{
+    const QString state = packageKitUpdatesState(m_lastRefresh);
+    if (state.isEmpty())
+        return;
+
+    if (state != m_simulationsState) {
+        m_simulations.clear();
+        m_simulationsState = state;
+    }
+    m_simulations.insert(simulationKey(packageIds), simulation);
+}
+
 void PackageKitBackend::addPackage(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary, bool arch)
 {
     if (PackageKit::Daemon::packageArch(packageId) == QLatin1String("source")) {
@@ -399,6 +506,7 @@ void PackageKitBackend::checkForUpdates()
         connect(m_refresher.data(), &PackageKit::Transaction::errorCode, this, &PackageKitBackend::transactionError);
         connect(m_refresher.data(), &PackageKit::Transaction::finished, this, [this]() {
             m_refresher = nullptr;
+            m_lastRefresh = QDateTime::currentSecsSinceEpoch();
             fetchUpdates();
             acquireFetching(false);
         });
@@ -553,6 +661,46 @@ void PackageKitBackend::runWhenInitialized(const std::function<void()> &f, QObje
     }
 }
 
+ResultsStream *PackageKitBackend::findResourcesByUrls(const QVector<QUrl> &urls)
+{
+    const bool allAppstream = std::all_of(urls.constBegin(), urls.constEnd(), [](const QUrl &url) {
+        return url.scheme() == QLatin1String("appstream");
+    });
+    if (!allAppstream)
+        return AbstractResourcesBackend::findResourcesByUrls(urls);
+
+    auto stream = new PKResultsStream(this, QStringLiteral("PackageKitStream-appstream-urls"));
+    const auto f = [this, urls, stream]() {
+        // One pass over the packages instead of one per url
+        QHash<QString, AbstractResource *> index;
+        index.reserve(m_packages.packages.size());
+        for (auto it = m_packages.packages.constBegin(), itEnd = m_packages.packages.constEnd(); it != itEnd; ++it) {
+            index.insert(AppStreamUtils::normalizedAppstreamId(it.key()), it.value());
+        }
+
+        QVector<AbstractResource *> resources;
+        for (const QUrl &url : urls) {
+            const auto appstreamIds = AppStreamUtils::appstreamIds(url);
+            if (appstreamIds.isEmpty())
+                continue;
+
+            for (const QString &id : AppStreamUtils::withDeprecatedAppstreamIds(appstreamIds)) {
+                AbstractResource *res = index.value(AppStreamUtils::normalizedAppstreamId(id));
+                if (res) {
+                    if (!resources.contains(res))
+                        resources += res;
+                    break;
+                }
+            }
+        }
+        if (!resources.isEmpty())
+            stream->setResources(resources);
+        stream->finish();
+    };
+    runWhenInitialized(f, stream);
+    return stream;
+}
+
 PKResultsStream *PackageKitBackend::findResourceByPackageName(const QUrl &url)
 {
     if (url.isLocalFile()) {
@@ -566,16 +714,6 @@ PKResultsStream *PackageKitBackend::findResourceByPackageName(const QUrl &url)
             return new PKResultsStream(this, QStringLiteral("PackageKitStream-localpkg"), {new LocalFilePKResource(url, this)});
         }
     } else if (url.scheme() == QLatin1String("appstream")) {
-        static const QMap<QString, QString> deprecatedAppstreamIds = {
-            {QStringLiteral("org.kde.krita.desktop"), QStringLiteral("krita.desktop")},
-            {QStringLiteral("org.kde.digikam.desktop"), QStringLiteral("digikam.desktop")},
-            {QStringLiteral("org.kde.ktorrent.desktop"), QStringLiteral("ktorrent.desktop")},
-            {QStringLiteral("org.kde.gcompris.desktop"), QStringLiteral("gcompris.desktop")},
-            {QStringLiteral("org.kde.kmymoney.desktop"), QStringLiteral("kmymoney.desktop")},
-            {QStringLiteral("org.kde.kolourpaint.desktop"), QStringLiteral("kolourpaint.desktop")},
-            {QStringLiteral("org.blender.blender.desktop"), QStringLiteral("blender.desktop")},
-        };
-
         const auto appstreamIds = AppStreamUtils::appstreamIds(url);
         if (appstreamIds.isEmpty())
             Q_EMIT passiveMessage(i18n("Malformed appstream url '%1'", url.toDisplayString()));
@@ -584,13 +722,7 @@ PKResultsStream *PackageKitBackend::findResourceByPackageName(const QUrl &url)
             const auto f = [this, appstreamIds, stream]() {
                 AbstractResource *pkg = nullptr;
 
-                QStringList allAppStreamIds = appstreamIds;
-                {
-                    auto it = deprecatedAppstreamIds.constFind(appstreamIds.first());
-                    if (it != deprecatedAppstreamIds.constEnd()) {
-                        allAppStreamIds << *it;
-                    }
-                }
+                const QStringList allAppStreamIds = AppStreamUtils::withDeprecatedAppstreamIds(appstreamIds);
 
                 for (auto it = m_packages.packages.constBegin(), itEnd = m_packages.packages.constEnd(); it != itEnd; ++it) {
                     const bool matches = kContains(allAppStreamIds, [&it](const QString &id) {
@@ -666,6 +798,28 @@ Transaction *PackageKitBackend::installApplication(AbstractResource *app)
     return new PKTransaction({app}, Transaction::InstallRole);
 }
 
+void PackageKitBackend::queueInstall(PKTransaction *transaction)
+{
+    m_installQueue += transaction;
+    if (!m_installQueueTimer.isActive())
+        m_installQueueTimer.start();
+}
+
+void PackageKitBackend::flushInstallQueue()
+{
+    QVector<PKTransaction *> batch;
+    for (const auto &transaction : qExchange(m_installQueue, {})) {
+        if (transaction && transaction->status() == Transaction::QueuedStatus)
+            batch += transaction;
+    }
+
+    if (!batch.isEmpty()) {
+        // One daemon transaction, with a single dependency solve and package manager lock, for all of them
+        auto leader = batch.takeFirst();
+        leader->startBatch(batch);
+    }
+}
+
 Transaction *PackageKitBackend::removeApplication(AbstractResource *app)
 {
     Q_ASSERT(!isFetching());
@@ -699,6 +853,13 @@ QSet<AbstractResource *> PackageKitBackend::upgradeablePackages() const
 
 void PackageKitBackend::addPackageToUpdate(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary)
 {
+    UpdatesCache::Update update;
+    update.id = packageId;
+    update.summary = summary;
+    update.info = info;
+    update.security = info == PackageKit::Transaction::InfoSecurity;
+    m_updatesToPublish += update;
+
     if (info == PackageKit::Transaction::InfoBlocked) {
         return;
     }
@@ -715,8 +876,13 @@ void PackageKitBackend::addPackageToUpdate(PackageKit::Transaction::Info info, c
     addPackage(info, packageId, summary, true);
 }
 
-void PackageKitBackend::getUpdatesFinished(PackageKit::Transaction::Exit, uint)
+void PackageKitBackend::getUpdatesFinished(PackageKit::Transaction::Exit exit, bool fromCache)
 {
+    // Only publish what was actually queried, not what got reused
+    if (!fromCache && exit == PackageKit::Transaction::ExitSuccess)
+        storePackageKitUpdates(m_lastRefresh, m_updatesToPublish);
+    m_updatesToPublish.clear();
+
     if (!m_updatesPackageId.isEmpty()) {
         resolvePackages(kTransform<QStringList>(m_updatesPackageId, [](const QString &pkgid) {
             return PackageKit::Daemon::packageName(pkgid);
@@ -17,6 +17,7 @@
 #include <QThreadPool>
 #include <QTimer>
 #include <QVariantList>
+#include <UpdatesCache.h>
 #include <resources/AbstractResourcesBackend.h>
 
 class AppPackageKitResource;
@@ -24,6 +25,15 @@ class PackageKitUpdater;
 class OdrsReviewsBackend;
 class PKResultsStream;
 class PKResolveTransaction;
+class PKTransaction;
+
+/// What installing some packages would do to the system, as reported by a simulated transaction
+struct PackageKitSimulation {
+    QMap<PackageKit::Transaction::Info, QStringList> packages;
+    QHash<QString, QString> summaries;
+    /// Whether the daemon could simulate it, the rest is empty otherwise
+    bool success = true;
+};
 
 class DISCOVERCOMMON_EXPORT PackageKitBackend : public AbstractResourcesBackend
 {
@@ -38,6 +48,7 @@ public:
 
     ResultsStream *search(const AbstractResourcesBackend::Filters &search) override;
     PKResultsStream *findResourceByPackageName(const QUrl &search);
+    ResultsStream *findResourcesByUrls(const QVector<QUrl> &urls) override;
     int updatesCount() const override;
     bool hasSecurityUpdates() const override;
 
@@ -78,6 +89,19 @@ public:
     void addPackageArch(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary);
     void addPackageNotArch(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary);
 
+    /**
+     * Simulates installing @p packageIds ahead of time, @p callback gets the result unless @p context is gone by then.
+     *
+     * Results are kept until the system changes, so the actual installation can skip its own simulation.
+     */
+    void simulateInstall(const QStringList &packageIds, QObject *context, const std::function<void(const PackageKitSimulation &)> &callback);
+    /// @returns the simulation of installing @p packageIds if there's one for the current state of the system, nullptr otherwise
+    const PackageKitSimulation *cachedSimulation(const QStringList &packageIds) const;
+    void storeSimulation(const QStringList &packageIds, const PackageKitSimulation &simulation);
+
+    /// Installs the resources of @p transaction along with the ones requested around the same time
+    void queueInstall(PKTransaction *transaction);
+
 public Q_SLOTS:
     void reloadPackageList();
     void transactionError(PackageKit::Transaction::Error, const QString &message);
@@ -87,7 +111,7 @@ private Q_SLOTS:
     void addPackage(PackageKit::Transaction::Info info, const QString &packageId, const QString &summary, bool arch);
     void packageDetails(const PackageKit::Details &details);
     void addPackageToUpdate(PackageKit::Transaction::Info, const QString &pkgid, const QString &summary);
-    void getUpdatesFinished(PackageKit::Transaction::Exit, uint);
+    void getUpdatesFinished(PackageKit::Transaction::Exit exit, bool fromCache);
 
 Q_SIGNALS:
     void loadedAppStream();
@@ -106,12 +130,18 @@ private:
     void performDetailsFetch();
     AppPackageKitResource *addComponent(const AppStream::Component &component, const QStringList &pkgNames);
     void updateProxy();
+    void flushInstallQueue();
 
     QScopedPointer<AppStream::Pool> m_appdata;
     PackageKitUpdater *m_updater;
     QPointer<PackageKit::Transaction> m_refresher;
     int m_isFetching;
     QSet<QString> m_updatesPackageId;
+    QVector<UpdatesCache::Update> m_updatesToPublish;
+    qint64 m_lastRefresh = 0;
+    QString m_simulationsState;
+    QHash<QString, PackageKitSimulation> m_simulations;
+    QHash<QString, QVector<QPair<QPointer<QObject>, std::function<void(const PackageKitSimulation &)>>>> m_pendingSimulations;
     bool m_hasSecurityUpdates = false;
     QSet<PackageKitResource *> m_packagesToAdd;
     QSet<PackageKitResource *> m_packagesToDelete;
@@ -124,6 +154,8 @@ private:
     } m_packages;
 
     QTimer m_delayedDetailsFetch;
+    QTimer m_installQueueTimer;
+    QVector<QPointer<PKTransaction>> m_installQueue;
     QSet<QString> m_packageNamesToFetchDetails;
     QSharedPointer<OdrsReviewsBackend> m_reviews;
     QPointer<PackageKit::Transaction> m_getUpdatesTransaction;
@@ -6,6 +6,7 @@
  */
 
 #include "PackageKitNotifier.h"
+#include "PackageKitUpdatesCache.h"
 
 #include <KConfigGroup>
 #include <KDesktopFile>
@@ -14,6 +15,9 @@
 #include <PackageKit/Daemon>
 #include <PackageKit/Offline>
 #include <QDBusInterface>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDateTime>
 #include <QDebug>
 #include <QFile>
 #include <QFileSystemWatcher>
@@ -159,9 +163,52 @@ void PackageKitNotifier::recheckSystemUpdateNeeded()
 
 void PackageKitNotifier::recheckSystemUpdate()
 {
-    if (PackageKit::Daemon::global()->isRunning()) {
-        PackageKit::Daemon::getUpdates();
-    }
+    if (!PackageKit::Daemon::global()->isRunning())
+        return;
+
+    auto watcher = new QDBusPendingCallWatcher(PackageKit::Daemon::getTimeSinceAction(PackageKit::Transaction::RoleRefreshCache), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<uint> reply = *watcher;
+        watcher->deleteLater();
+        m_lastRefresh = reply.isValid() ? QDateTime::currentSecsSinceEpoch() - reply.value() : 0;
+
+        // Discover might have just asked for the same
+        QVector<UpdatesCache::Update> published;
+        if (!loadPackageKitUpdates(m_lastRefresh, &published)) {
+            fetchUpdates();
+            return;
+        }
+
+        uint normalUpdates = 0, securityUpdates = 0;
+        for (const auto &update : qAsConst(published)) {
+            if (update.info == PackageKit::Transaction::InfoBlocked)
+                continue;
+            if (update.security)
+                ++securityUpdates;
+            else
+                ++normalUpdates;
+        }
+        setUpdates(normalUpdates, securityUpdates);
+    });
+}
+
+void PackageKitNotifier::fetchUpdates()
+{
+    // The results get counted through transactionListChanged, here they're only gathered to be published
+    auto trans = PackageKit::Daemon::getUpdates();
+    auto updates = QSharedPointer<QVector<UpdatesCache::Update>>::create();
+    connect(trans, &PackageKit::Transaction::package, this, [updates](PackageKit::Transaction::Info info, const QString &packageID, const QString &summary) {
+        UpdatesCache::Update update;
+        update.id = packageID;
+        update.summary = summary;
+        update.info = info;
+        update.security = info == PackageKit::Transaction::InfoSecurity;
+        updates->append(update);
+    });
+    connect(trans, &PackageKit::Transaction::finished, this, [this, updates](PackageKit::Transaction::Exit exit) {
+        if (exit == PackageKit::Transaction::ExitSuccess)
+            storePackageKitUpdates(m_lastRefresh, *updates);
+    });
 }
 
 void PackageKitNotifier::setupGetUpdatesTransaction(PackageKit::Transaction *trans)
@@ -194,8 +241,11 @@ void PackageKitNotifier::finished(PackageKit::Transaction::Exit /*exit*/, uint)
 {
     const PackageKit::Transaction *trans = qobject_cast<PackageKit::Transaction *>(sender());
 
-    const uint normalUpdates = trans->property("normalUpdates").toInt();
-    const uint securityUpdates = trans->property("securityUpdates").toInt();
+    setUpdates(trans->property("normalUpdates").toInt(), trans->property("securityUpdates").toInt());
+}
+
+void PackageKitNotifier::setUpdates(uint normalUpdates, uint securityUpdates)
+{
     const bool changed = normalUpdates != m_normalUpdates || securityUpdates != m_securityUpdates;
 
     m_normalUpdates = normalUpdates;
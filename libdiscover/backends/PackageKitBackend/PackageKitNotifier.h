@@ -10,6 +10,7 @@
 #include <PackageKit/Transaction>
 #include <QPointer>
 #include <QVariantList>
+#include <UpdatesCache.h>
 #include <functional>
 
 class QTimer;
@@ -45,6 +46,8 @@ private:
     void recheckSystemUpdate();
     void checkOfflineUpdates();
     void setupGetUpdatesTransaction(PackageKit::Transaction *transaction);
+    void fetchUpdates();
+    void setUpdates(uint normalUpdates, uint securityUpdates);
     QProcess *checkAptVariable(const QString &aptconfig, const QLatin1String &varname, const std::function<void(const QStringRef &val)> &func);
 
     bool m_needsReboot = false;
@@ -53,6 +56,7 @@ private:
     QPointer<PackageKit::Transaction> m_refresher;
     QPointer<PackageKit::Transaction> m_distUpgrades;
     QTimer *m_recheckTimer;
+    qint64 m_lastRefresh = 0;
 
     QHash<QString, PackageKit::Transaction *> m_transactions;
 };
@@ -14,6 +14,7 @@
 #include <PackageKit/Daemon>
 #include <QDebug>
 #include <QJsonArray>
+#include <QJsonObject>
 #include <QProcess>
 #include <utils.h>
 
@@ -206,7 +207,7 @@ void PackageKitResource::setDetails(const PackageKit::Details &details)
             emit stateChanged();
 
         if (!backend()->isFetching())
-            Q_EMIT backend()->resourcesChanged(this, {"size", "homepage", "license"});
+            backend()->reportResourceChanged(this, {"size", "homepage", "license"});
 
         if (oldSize != uint(size())) {
             Q_EMIT sizeChanged();
@@ -336,6 +337,21 @@ QString PackageKitResource::sourceIcon() const
     return QStringLiteral("package-x-generic");
 }
 
+static bool dependencyLessThan(const QJsonValue &a, const QJsonValue &b)
+{
+    const auto objA = a.toObject(), objB = b.toObject();
+    return objA[QLatin1String("packageInfo")].toString() < objB[QLatin1String("packageInfo")].toString()
+        || (objA[QLatin1String("packageInfo")].toString() == objB[QLatin1String("packageInfo")].toString()
+            && objA[QLatin1String("packageName")].toString() < objB[QLatin1String("packageName")].toString());
+}
+
+static QJsonObject dependencyObject(PackageKit::Transaction::Info info, const QString &packageID, const QString &summary)
+{
+    return QJsonObject{{QStringLiteral("packageName"), PackageKit::Daemon::packageName(packageID)},
+                       {QStringLiteral("packageInfo"), PackageKitMessages::info(info)},
+                       {QStringLiteral("packageDescription"), summary}};
+}
+
 void PackageKitResource::fetchDependencies()
 {
     const auto id = isInstalled() ? installedPackageId() : availablePackageId();
@@ -343,6 +359,34 @@ void PackageKitResource::fetchDependencies()
         return;
     m_dependenciesCount = 0;
 
+    if (!isInstalled()) {
+        // What installing would bring along, the same simulation is reused if the user decides to install
+        backend()->simulateInstall({id}, this, [this, id](const PackageKitSimulation &simulation) {
+            if (!simulation.success) {
+                fetchDependsOn(id);
+                return;
+            }
+
+            QJsonArray packageDependencies;
+            for (auto it = simulation.packages.constBegin(), itEnd = simulation.packages.constEnd(); it != itEnd; ++it) {
+                for (const QString &packageID : it.value()) {
+                    if (packageID != id)
+                        packageDependencies.append(dependencyObject(it.key(), packageID, simulation.summaries.value(packageID)));
+                }
+            }
+            std::sort(packageDependencies.begin(), packageDependencies.end(), dependencyLessThan);
+
+            Q_EMIT dependenciesFound(packageDependencies);
+            setDependenciesCount(packageDependencies.size());
+        });
+        return;
+    }
+
+    fetchDependsOn(id);
+}
+
+void PackageKitResource::fetchDependsOn(const QString &id)
+{
     auto packageDependencies = QSharedPointer<QJsonArray>::create();
 
     auto trans = PackageKit::Daemon::dependsOn(id);
@@ -353,18 +397,10 @@ void PackageKitResource::fetchDependencies()
             &PackageKit::Transaction::package,
             this,
             [packageDependencies](PackageKit::Transaction::Info info, const QString &packageID, const QString &summary) {
-                (*packageDependencies)
-                    .append(QJsonObject{{QStringLiteral("packageName"), PackageKit::Daemon::packageName(packageID)},
-                                        {QStringLiteral("packageInfo"), PackageKitMessages::info(info)},
-                                        {QStringLiteral("packageDescription"), summary}});
+                packageDependencies->append(dependencyObject(info, packageID, summary));
             });
     connect(trans, &PackageKit::Transaction::finished, this, [this, packageDependencies](PackageKit::Transaction::Exit /*status*/) {
-        std::sort(packageDependencies->begin(), packageDependencies->end(), [](QJsonValue a, QJsonValue b) {
-            const auto objA = a.toObject(), objB = b.toObject();
-            return objA[QLatin1String("packageInfo")].toString() < objB[QLatin1String("packageInfo")].toString()
-                || (objA[QLatin1String("packageInfo")].toString() == objB[QLatin1String("packageInfo")].toString()
-                    && objA[QLatin1String("packageName")].toString() < objB[QLatin1String("packageName")].toString());
-        });
+        std::sort(packageDependencies->begin(), packageDependencies->end(), dependencyLessThan);
 
         Q_EMIT dependenciesFound(*packageDependencies);
         setDependenciesCount(packageDependencies->size());
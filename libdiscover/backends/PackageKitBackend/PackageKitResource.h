@@ -110,6 +110,7 @@ protected:
 
 private:
     void fetchDependencies();
+    void fetchDependsOn(const QString &id);
     /** fetches details individually, it's better if done in batch, like for updates */
     virtual void fetchDetails();
 
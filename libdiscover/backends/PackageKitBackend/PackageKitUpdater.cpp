@@ -208,7 +208,7 @@ public:
 
     void refreshResource()
     {
-        Q_EMIT m_backend->resourcesChanged(this, {"size", "license"});
+        m_backend->reportResourceChanged(this, {"size", "license"});
     }
 
     void setCandidates(const QSet<AbstractResource *> &candidates)
@@ -0,0 +1,36 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "PackageKitUpdatesCache.h"
+#include "config-packagekit.h"
+
+/// How long a published GetUpdates result is trusted, in seconds
+static const int s_packageKitUpdatesMaxAge = 30 * 60;
+
+QString packageKitUpdatesState(qint64 lastRefresh)
+{
+    if (lastRefresh <= 0)
+        return {};
+
+    const QString transactions = UpdatesCache::stateOfFiles({QStringLiteral(PACKAGEKIT_STATE_DIR "/transactions.db")});
+    if (transactions.isEmpty())
+        return {};
+
+    // Both processes derive the refresh time from the time elapsed since, allow them to disagree by a bit
+    return transactions + QLatin1String(";refreshed@") + QString::number(lastRefresh / 60);
+}
+
+bool loadPackageKitUpdates(qint64 lastRefresh, QVector<UpdatesCache::Update> *updates)
+{
+    return UpdatesCache(QStringLiteral("packagekit")).load(packageKitUpdatesState(lastRefresh), s_packageKitUpdatesMaxAge, updates);
+}
+
+void storePackageKitUpdates(qint64 lastRefresh, const QVector<UpdatesCache::Update> &updates)
+{
+    const QString state = packageKitUpdatesState(lastRefresh);
+    if (!state.isEmpty())
+        UpdatesCache(QStringLiteral("packagekit")).store(state, updates);
+}
@@ -0,0 +1,28 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#ifndef PACKAGEKITUPDATESCACHE_H
+#define PACKAGEKITUPDATESCACHE_H
+
+#include <UpdatesCache.h>
+
+// Shared by the backend and the notifier, so GetUpdates only runs in one of them
+
+/**
+ * PackageKit records the transactions that change the system, while @p lastRefresh
+ * (in seconds since epoch, as reported by the daemon) tells when the cache got refreshed.
+ *
+ * @returns an empty state when it can't be told, in which case nothing should be reused
+ */
+QString packageKitUpdatesState(qint64 lastRefresh);
+
+/// @returns whether the updates published for @p lastRefresh are still valid, in which case they are set in @p updates
+bool loadPackageKitUpdates(qint64 lastRefresh, QVector<UpdatesCache::Update> *updates);
+
+/// Publishes the result of a GetUpdates transaction run after @p lastRefresh
+void storePackageKitUpdates(qint64 lastRefresh, const QVector<UpdatesCache::Update> &updates);
+
+#endif // PACKAGEKITUPDATESCACHE_H
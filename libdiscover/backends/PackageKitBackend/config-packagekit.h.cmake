@@ -0,0 +1 @@
+#define PACKAGEKIT_STATE_DIR "@PACKAGEKIT_STATE_DIR@"
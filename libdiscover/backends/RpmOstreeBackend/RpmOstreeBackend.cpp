@@ -12,6 +12,7 @@
 #include <QDBusInterface>
 #include <QDBusMessage>
 #include <QDBusObjectPath>
+#include <QDBusPendingCallWatcher>
 #include <QDBusPendingReply>
 #include <QDebug>
 #include <QList>
@@ -74,113 +75,250 @@ private:
     QStandardItemModel *const m_model;
 };
 
+static const QString s_service = QStringLiteral("org.projectatomic.rpmostree1");
+static const QString s_sysrootPath = QStringLiteral("/org/projectatomic/rpmostree1/Sysroot");
+static const QString s_osPath = QStringLiteral("/org/projectatomic/rpmostree1/fedora");
+
+static QDBusPendingCall getProperty(const QString &path, const QString &interface, const QString &name)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(s_service, path, QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("Get"));
+    message << interface << name;
+    return QDBusConnection::systemBus().asyncCall(message);
+}
+
 RpmOstreeBackend::RpmOstreeBackend(QObject *parent)
     : AbstractResourcesBackend(parent)
     , m_updater(new StandardBackendUpdater(this))
-    , m_fetching(false)
+    , m_os(new OrgProjectatomicRpmostree1OSInterface(s_service, s_osPath, QDBusConnection::systemBus(), this))
+    , m_fetching(0)
     , m_isDeploymentUpdate(true)
 {
     connect(m_updater, &StandardBackendUpdater::updatesCountChanged, this, &RpmOstreeBackend::updatesCountChanged);
+
+    // The daemon tells when the deployments or the cached update change, no need to poll
+    for (const QString &path : {s_sysrootPath, s_osPath}) {
+        QDBusConnection::systemBus().connect(s_service,
+                                             path,
+                                             QStringLiteral("org.freedesktop.DBus.Properties"),
+                                             QStringLiteral("PropertiesChanged"),
+                                             this,
+                                             SLOT(propertiesChanged(QString, QVariantMap, QStringList)));
+    }
+
     getDeployments();
     SourcesModel::global()->addSourcesBackend(new RpmOstreeSourcesBackend(this));
-    executeCheckUpdateProcess();
+    getCachedUpdate();
+    checkDeploymentUpdate();
     executeRemoteRefsProcess();
 }
 
+void RpmOstreeBackend::propertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated)
+{
+    const QString deployments = QStringLiteral("Deployments");
+    const QString cachedUpdate = QStringLiteral("CachedUpdate");
+    if (interface == QLatin1String("org.projectatomic.rpmostree1.Sysroot")) {
+        if (changed.contains(deployments)) {
+            setDeployments(changed.value(deployments).value<QDBusArgument>());
+        } else if (invalidated.contains(deployments)) {
+            getDeployments();
+        }
+    } else if (interface == QLatin1String("org.projectatomic.rpmostree1.OS")) {
+        if (changed.contains(cachedUpdate)) {
+            setCachedUpdate(qdbus_cast<QVariantMap>(changed.value(cachedUpdate)));
+        } else if (invalidated.contains(cachedUpdate)) {
+            getCachedUpdate();
+        }
+    }
+}
+
 void RpmOstreeBackend::getDeployments()
 {
+    // Searches would come back empty until the deployments are there
+    acquireFetching(true);
     // reading Deployments property from "org.projectatomic.rpmostree1.Sysroot" interface
-    QDBusInterface interface(QStringLiteral("org.projectatomic.rpmostree1"),
-                             QStringLiteral("/org/projectatomic/rpmostree1/Sysroot"),
-                             QStringLiteral("org.freedesktop.DBus.Properties"),
-                             QDBusConnection::systemBus());
-    QDBusMessage result = interface.call(QStringLiteral("Get"), QStringLiteral("org.projectatomic.rpmostree1.Sysroot"), QStringLiteral("Deployments"));
-    QList<QVariant> outArgs = result.arguments();
-    QVariant first = outArgs.at(0);
-    QDBusVariant dbvFirst = first.value<QDBusVariant>();
-    QVariant vFirst = dbvFirst.variant();
-    QDBusArgument dbusArgs = vFirst.value<QDBusArgument>();
+    auto watcher = new QDBusPendingCallWatcher(getProperty(s_sysrootPath, QStringLiteral("org.projectatomic.rpmostree1.Sysroot"), QStringLiteral("Deployments")), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        QDBusPendingReply<QDBusVariant> reply = *watcher;
+        if (reply.isError()) {
+            qWarning() << "could not get the rpm-ostree deployments" << reply.error();
+        } else {
+            setDeployments(reply.value().variant().value<QDBusArgument>());
+        }
+        acquireFetching(false);
+    });
+}
+
+void RpmOstreeBackend::setDeployments(const QDBusArgument &dbusArgs)
+{
+    // The resources for deployments we knew already are kept, only the new ones are created
+    QHash<QString, RpmOstreeResource *> previous;
+    for (RpmOstreeResource *resource : qAsConst(m_resources)) {
+        previous.insert(resource->checksum(), resource);
+    }
+    m_resources.clear();
 
     // storing the extracted deployments from DBus
     dbusArgs.beginArray();
     while (!dbusArgs.atEnd()) {
         QMap<QString, QVariant> map;
         dbusArgs >> map;
-        QDBusArgument dbusArgsSignature = map[QStringLiteral("signatures")].value<QDBusArgument>();
-        dbusArgsSignature >> map[QStringLiteral("signatures")];
-        QDBusVariant dbvFirst1 = map[QStringLiteral("signatures")].value<QDBusVariant>();
-        QVariant vFirst1 = dbvFirst1.variant();
-        QDBusArgument dbusArgsSign = vFirst1.value<QDBusArgument>();
-        dbusArgsSign >> map[QStringLiteral("signatures")];
-
-        QString baseVersion = map[QStringLiteral("version")].toString();
-        QString deploymentName = baseVersion;
-        deploymentName.remove(8, deploymentName.size() - 1);
-        baseVersion.remove(0, 7);
 
         const QString baseChecksum = map[QStringLiteral("checksum")].toString();
-        const QString signature = map[QStringLiteral("signatures")].toString();
-        const QString layeredPackages = map[QStringLiteral("packages")].toString();
-        const QString localPackages = map[QStringLiteral("requested-local-packages")].toString();
-        const QString origin = map[QStringLiteral("origin")].toString();
-        const qulonglong timestamp = map[QStringLiteral("timestamp")].toULongLong();
-
-        RpmOstreeResource *deploymentResource =
-            new RpmOstreeResource(deploymentName, baseVersion, baseChecksum, signature, layeredPackages, localPackages, origin, timestamp, this);
+        RpmOstreeResource *deploymentResource = previous.take(baseChecksum);
+        if (!deploymentResource) {
+            QDBusArgument dbusArgsSignature = map[QStringLiteral("signatures")].value<QDBusArgument>();
+            dbusArgsSignature >> map[QStringLiteral("signatures")];
+            QDBusVariant dbvFirst1 = map[QStringLiteral("signatures")].value<QDBusVariant>();
+            QVariant vFirst1 = dbvFirst1.variant();
+            QDBusArgument dbusArgsSign = vFirst1.value<QDBusArgument>();
+            dbusArgsSign >> map[QStringLiteral("signatures")];
+
+            QString baseVersion = map[QStringLiteral("version")].toString();
+            QString deploymentName = baseVersion;
+            deploymentName.remove(8, deploymentName.size() - 1);
+            baseVersion.remove(0, 7);
+
+            const QString signature = map[QStringLiteral("signatures")].toString();
+            const QString layeredPackages = map[QStringLiteral("packages")].toString();
+            const QString localPackages = map[QStringLiteral("requested-local-packages")].toString();
+            const QString origin = map[QStringLiteral("origin")].toString();
+            const qulonglong timestamp = map[QStringLiteral("timestamp")].toULongLong();
+
+            deploymentResource =
+                new RpmOstreeResource(deploymentName, baseVersion, baseChecksum, signature, layeredPackages, localPackages, origin, timestamp, this);
+            connect(deploymentResource, &RpmOstreeResource::stateChanged, this, &RpmOstreeBackend::updatesCountChanged);
+        }
         if (map[QStringLiteral("booted")].toBool()) {
             // changing the state of the booted deployment resource to Installed.
             deploymentResource->setState(AbstractResource::Installed);
+        } else if (deploymentResource->state() == AbstractResource::Installed) {
+            deploymentResource->setState(AbstractResource::None);
         }
-        connect(deploymentResource, &RpmOstreeResource::stateChanged, this, &RpmOstreeBackend::updatesCountChanged);
         m_resources.push_back(deploymentResource);
     }
     dbusArgs.endArray();
+
+    for (RpmOstreeResource *resource : qAsConst(previous)) {
+        Q_EMIT resourceRemoved(resource);
+        resource->deleteLater();
+    }
+    applyUpdateInformation();
 }
 
-void RpmOstreeBackend::toggleFetching()
+void RpmOstreeBackend::acquireFetching(bool f)
 {
-    m_fetching = !m_fetching;
-    emit fetchingChanged();
+    if (f)
+        m_fetching++;
+    else
+        m_fetching--;
+
+    if ((!f && m_fetching == 0) || (f && m_fetching == 1))
+        emit fetchingChanged();
+    Q_ASSERT(m_fetching >= 0);
 }
 
-void RpmOstreeBackend::executeCheckUpdateProcess()
+void RpmOstreeBackend::checkDeploymentUpdate()
 {
-    QProcess *process = new QProcess(this);
+    acquireFetching(true);
+    // Same as what "rpm-ostree update --check" asks the daemon for
+    auto watcher = new QDBusPendingCallWatcher(m_os->AutomaticUpdateTrigger(QVariantMap{{QStringLiteral("mode"), QStringLiteral("check")}}), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        QDBusPendingReply<bool, QString> reply = *watcher;
+        if (reply.isError()) {
+            qWarning() << "could not check for rpm-ostree updates" << reply.error();
+            acquireFetching(false);
+            return;
+        }
 
-    connect(process, &QProcess::readyReadStandardError, [process]() {
-        qDebug() << "rpm-ostree errors" << process->readAllStandardError().constData();
+        const bool enabled = reply.argumentAt<0>();
+        const QString address = reply.argumentAt<1>();
+        if (!enabled || address.isEmpty()) {
+            // Nothing got started, what the daemon knows already is all there is
+            qWarning() << "rpm-ostree did not start checking for updates" << enabled << address;
+            getCachedUpdate();
+            acquireFetching(false);
+            return;
+        }
+
+        runTransaction(address, [this] {
+            // Usually notified already, but the daemon might be gone by the time we listen
+            getCachedUpdate();
+            acquireFetching(false);
+        });
     });
+}
 
-    toggleFetching();
-    // delete process instance when done, and get the exit status to handle errors.
-    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), [this, process](int exitCode, QProcess::ExitStatus exitStatus) {
-        qDebug() << "process exited with code " << exitCode << exitStatus;
-        if (exitCode == 0) {
-            readUpdateOutput(process);
+void RpmOstreeBackend::runTransaction(const QString &address, const std::function<void()> &finished)
+{
+    QDBusConnection socketConnection = QDBusConnection::connectToPeer(address, address);
+    if (!socketConnection.isConnected()) {
+        qWarning() << "could not connect to the rpm-ostree transaction" << address << socketConnection.lastError();
+        QDBusConnection::disconnectFromPeer(address);
+        finished();
+        return;
+    }
+
+    auto transaction = new OrgProjectatomicRpmostree1TransactionInterface(QString(), QStringLiteral("/"), socketConnection, this);
+    // Either the transaction finishes or it can't be started, whichever comes first
+    auto done = QSharedPointer<bool>::create(false);
+    auto finish = [transaction, address, finished, done] {
+        if (*done)
+            return;
+        *done = true;
+        transaction->deleteLater();
+        QDBusConnection::disconnectFromPeer(address);
+        finished();
+    };
+    connect(transaction, &OrgProjectatomicRpmostree1TransactionInterface::Finished, this, [finish](bool success, const QString &error) {
+        if (!success) {
+            qWarning() << "rpm-ostree transaction failed" << error;
         }
-        toggleFetching();
-        process->deleteLater();
+        finish();
     });
 
-    process->setProcessChannelMode(QProcess::MergedChannels);
-    process->start(QStringLiteral("rpm-ostree"), {QStringLiteral("update"), QStringLiteral("--check")});
+    // The transaction only runs once its client started it, we get to know about it through Finished
+    auto watcher = new QDBusPendingCallWatcher(transaction->Start(), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [finish](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        QDBusPendingReply<bool> reply = *watcher;
+        if (reply.isError()) {
+            qWarning() << "could not start the rpm-ostree transaction" << reply.error();
+            finish();
+        }
+    });
 }
 
-void RpmOstreeBackend::readUpdateOutput(QIODevice *device)
+void RpmOstreeBackend::getCachedUpdate()
 {
-    QString newVersionFound;
-
-    QTextStream stream(device);
-    for (QString line = stream.readLine(); stream.readLineInto(&line);) {
-        if (line.contains(QLatin1String("Version"))) {
-            newVersionFound = line;
+    auto watcher = new QDBusPendingCallWatcher(getProperty(s_osPath, QStringLiteral("org.projectatomic.rpmostree1.OS"), QStringLiteral("CachedUpdate")), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        QDBusPendingReply<QDBusVariant> reply = *watcher;
+        if (reply.isError()) {
+            qWarning() << "could not get the rpm-ostree cached update" << reply.error();
+            return;
         }
-    }
+        setCachedUpdate(qdbus_cast<QVariantMap>(reply.value().variant()));
+    });
+}
+
+void RpmOstreeBackend::setCachedUpdate(const QVariantMap &update)
+{
+    // Empty when there is no update
+    m_cachedUpdateVersion = update.value(QStringLiteral("version")).toString();
+    applyUpdateInformation();
+}
+
+void RpmOstreeBackend::applyUpdateInformation()
+{
+    if (m_resources.isEmpty())
+        return;
 
-    if (!newVersionFound.isEmpty()) {
-        newVersionFound.remove(0, 25);
-        newVersionFound.remove(13, newVersionFound.size() - 13);
-        m_resources[0]->setNewVersion(newVersionFound);
+    m_resources[0]->setRemoteRefsList(m_remoteRefs);
+    if (!m_cachedUpdateVersion.isEmpty()) {
+        m_resources[0]->setNewVersion(m_cachedUpdateVersion);
         m_resources[0]->setState(AbstractResource::Upgradeable);
     }
 }
@@ -218,7 +356,8 @@ void RpmOstreeBackend::readRefsOutput(QIODevice *device)
             continue;
         remoteRefs.push_back(ref);
     }
-    m_resources[0]->setRemoteRefsList(remoteRefs);
+    m_remoteRefs = remoteRefs;
+    applyUpdateInformation();
 }
 
 int RpmOstreeBackend::updatesCount() const
@@ -284,9 +423,9 @@ void RpmOstreeBackend::updateCurrentDeployment()
 
 void RpmOstreeBackend::checkForUpdates()
 {
-    if (m_fetching)
+    if (isFetching())
         return;
-    executeCheckUpdateProcess();
+    checkDeploymentUpdate();
     executeRemoteRefsProcess();
 }
 
@@ -16,6 +16,7 @@
 #include <QSharedPointer>
 #include <QThreadPool>
 #include <QtDBus/QDBusPendingReply>
+#include <functional>
 
 class RpmOstreeReviewsBackend;
 class OdrsReviewsBackend;
@@ -28,22 +29,24 @@ public:
     explicit RpmOstreeBackend(QObject *parent = nullptr);
 
     /*
-     * Getting the list of deployments from the rpm-ostree DBus class and
+     * Getting the list of deployments from the rpm-ostree DBus class without blocking and
      * converting each deployment to resource and detecting the currently running deployment.
-     * It is corresponding to "rpm-ostree status".
+     * It is corresponding to "rpm-ostree status" and is called again whenever the daemon
+     * tells that the deployments changed.
      */
     void getDeployments();
 
     /*
-     * Executing "rpm-ostree update --check" using QProcess to check if
-     * there is a new deployment version avaliable.
+     * Asking the rpm-ostree daemon to check if there is a new deployment version avaliable,
+     * like "rpm-ostree update --check" does. The daemon publishes the result in the
+     * CachedUpdate property.
      */
-    void executeCheckUpdateProcess();
+    void checkDeploymentUpdate();
 
     /*
-     * Getting the output resulting from executing the QProcess update check.
+     * Reading the CachedUpdate property from the rpm-ostree DBus class without blocking.
      */
-    void readUpdateOutput(QIODevice *process);
+    void getCachedUpdate();
 
     /*
      * Calling UpdateDeployment method from the rpm-ostree DBus class when
@@ -84,21 +87,32 @@ public:
     Transaction *removeApplication(AbstractResource *) override;
     bool isFetching() const override
     {
-        return m_fetching;
+        return m_fetching > 0;
     }
     void checkForUpdates() override;
     QString displayName() const override;
     bool hasApplications() const override;
 
-public Q_SLOTS:
-    void toggleFetching();
+private Q_SLOTS:
+    void propertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated);
 
 private:
+    void setDeployments(const QDBusArgument &deployments);
+    void setCachedUpdate(const QVariantMap &update);
+    void applyUpdateInformation();
+    void runTransaction(const QString &address, const std::function<void()> &finished);
+    void acquireFetching(bool f);
+
     StandardBackendUpdater *m_updater;
+    OrgProjectatomicRpmostree1OSInterface *const m_os;
     QVector<RpmOstreeResource *> m_resources;
 
+    // Kept until the deployments are there to apply them to
+    QString m_cachedUpdateVersion;
+    QStringList m_remoteRefs;
+
     QString m_transactionUpdatePath;
-    bool m_fetching;
+    int m_fetching;
 
     /*
      * Checking if the required update is deployment update or system upgrade
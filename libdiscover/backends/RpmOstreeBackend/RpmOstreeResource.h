@@ -72,6 +72,10 @@ public:
     QUrl donationURL() override;
     void setState(AbstractResource::State);
     void setRemoteRefsList(QStringList remoteRefs);
+    QString checksum() const
+    {
+        return m_checkSum;
+    }
     static const QStringList m_objects;
 
     /*
@@ -17,6 +17,8 @@
 #include <Snapd/MarkdownParser>
 #endif
 
+#include <resources/IconLoader.h>
+
 #include <utils.h>
 
 QDebug operator<<(QDebug debug, const QSnapdPlug &plug)
@@ -104,14 +106,23 @@ int SnapResource::size()
 QVariant SnapResource::icon() const
 {
     if (m_icon.isNull()) {
-        m_icon = [this]() -> QVariant {
-            const auto iconPath = m_snap->icon();
-            if (iconPath.isEmpty())
+        const auto iconPath = m_snap->icon();
+        if (!iconPath.isEmpty() && !iconPath.startsWith(QLatin1Char('/'))) {
+            const QString path = IconLoader::global()->fetchRemote(QUrl(iconPath), const_cast<SnapResource *>(this));
+            // Not kept until it's downloaded, iconChanged() tells when to ask again
+            if (path.isEmpty())
                 return QStringLiteral("package-x-generic");
+            m_icon = QUrl::fromLocalFile(path);
+            return m_icon;
+        }
 
-            if (!iconPath.startsWith(QLatin1Char('/')))
-                return QUrl(iconPath);
+        m_icon = [this, iconPath]() -> QVariant {
+            if (iconPath.isEmpty())
+                return QStringLiteral("package-x-generic");
 
+            if (m_iconRequested)
+                return {};
+            m_iconRequested = true;
             auto req = client()->getIcon(packageName());
             connect(req, &QSnapdGetIconRequest::complete, this, &SnapResource::gotIcon);
             req->runAsync();
@@ -126,6 +137,8 @@ void SnapResource::gotIcon()
     auto req = qobject_cast<QSnapdGetIconRequest *>(sender());
     if (req->error()) {
         qWarning() << "icon error" << req->errorString();
+        m_icon = QStringLiteral("package-x-generic");
+        Q_EMIT iconChanged();
         return;
     }
 
@@ -85,6 +85,7 @@ public:
 
     QSharedPointer<QSnapdSnap> m_snap;
     mutable QVariant m_icon;
+    mutable bool m_iconRequested = false;
     static const QStringList m_objects;
 };
 
@@ -0,0 +1,100 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "UpdatesCache.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+// Notifier and Discover don't share an application name, so use the generic location
+static QString cacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/discover/updates");
+}
+
+UpdatesCache::UpdatesCache(const QString &name)
+    : m_path(cacheDirectory() + QLatin1Char('/') + name + QLatin1String(".json"))
+{
+}
+
+void UpdatesCache::store(const QString &state, const QVector<Update> &updates)
+{
+    if (state.isEmpty())
+        return;
+
+    QJsonArray array;
+    for (const Update &update : updates) {
+        array.append(QJsonObject{
+            {QStringLiteral("id"), update.id},
+            {QStringLiteral("summary"), update.summary},
+            {QStringLiteral("info"), update.info},
+            {QStringLiteral("security"), update.security},
+            {QStringLiteral("downloadSize"), QString::number(update.downloadSize)},
+        });
+    }
+    const QJsonObject root{
+        {QStringLiteral("state"), state},
+        {QStringLiteral("timestamp"), QDateTime::currentSecsSinceEpoch()},
+        {QStringLiteral("updates"), array},
+    };
+
+    QDir().mkpath(cacheDirectory());
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "could not publish the updates at" << m_path << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    file.commit();
+}
+
+bool UpdatesCache::load(const QString &state, int maxAge, QVector<Update> *updates) const
+{
+    if (state.isEmpty())
+        return false;
+
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    const qint64 age = QDateTime::currentSecsSinceEpoch() - root.value(QLatin1String("timestamp")).toVariant().toLongLong();
+    if (root.value(QLatin1String("state")).toString() != state || age < 0 || age > maxAge)
+        return false;
+
+    const QJsonArray array = root.value(QLatin1String("updates")).toArray();
+    updates->clear();
+    updates->reserve(array.size());
+    for (const QJsonValue &value : array) {
+        const QJsonObject object = value.toObject();
+        Update update;
+        update.id = object.value(QLatin1String("id")).toString();
+        update.summary = object.value(QLatin1String("summary")).toString();
+        update.info = object.value(QLatin1String("info")).toInt();
+        update.security = object.value(QLatin1String("security")).toBool();
+        update.downloadSize = object.value(QLatin1String("downloadSize")).toString().toULongLong();
+        updates->append(update);
+    }
+    return true;
+}
+
+QString UpdatesCache::stateOfFiles(const QStringList &paths)
+{
+    QStringList ret;
+    for (const QString &path : paths) {
+        const QFileInfo info(path);
+        if (info.exists())
+            ret += path + QLatin1Char('@') + QString::number(info.lastModified().toMSecsSinceEpoch());
+    }
+    return ret.join(QLatin1Char(';'));
+}
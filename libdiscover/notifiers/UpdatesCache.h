@@ -0,0 +1,58 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#ifndef UPDATESCACHE_H
+#define UPDATESCACHE_H
+
+#include "discovernotifiers_export.h"
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * \class UpdatesCache  UpdatesCache.h "UpdatesCache.h"
+ *
+ * \brief Result of the last update check, shared between the notifier and Discover.
+ *
+ * Whichever process checked for updates last publishes what it found, so the
+ * other one can reuse it instead of querying the remotes or the daemon again.
+ *
+ * A result is only reused while the system is in the same state it was computed in,
+ * as described by a backend-defined token (e.g. when the installation last changed),
+ * and for as long as it's younger than the age the caller accepts.
+ */
+class DISCOVERNOTIFIERS_EXPORT UpdatesCache
+{
+public:
+    struct Update {
+        QString id;
+        QString summary;
+        /// backend-specific kind of update
+        int info = 0;
+        bool security = false;
+        quint64 downloadSize = 0;
+    };
+
+    /// @p name identifies the source of the updates, e.g. "packagekit" or "flatpak-system"
+    explicit UpdatesCache(const QString &name);
+
+    /// Publishes @p updates, found while the system was in @p state
+    void store(const QString &state, const QVector<Update> &updates);
+
+    /**
+     * @returns whether updates found less than @p maxAge seconds ago in @p state were published,
+     * in which case they are set in @p updates.
+     */
+    bool load(const QString &state, int maxAge, QVector<Update> *updates) const;
+
+    /// @returns a state token that changes whenever any of @p paths is modified, empty if none exists
+    static QString stateOfFiles(const QStringList &paths);
+
+private:
+    const QString m_path;
+};
+
+#endif // UPDATESCACHE_H
@@ -6,7 +6,10 @@
 
 #include "AbstractResource.h"
 #include "AbstractResourcesBackend.h"
+#include "Collation.h"
+#include "StringInterner.h"
 #include "libdiscover_debug.h"
+#include <Category/CategoryMatcher.h>
 #include <Category/CategoryModel.h>
 #include <KFormat>
 #include <KLocalizedString>
@@ -15,6 +18,7 @@
 #include <QProcess>
 #include <ReviewsBackend/AbstractReviewsBackend.h>
 #include <ReviewsBackend/Rating.h>
+#include <utils.h>
 
 AbstractResource::AbstractResource(AbstractResourcesBackend *parent)
     : QObject(parent)
@@ -48,12 +52,22 @@ QUrl AbstractResource::donationURL()
 
 void AbstractResource::addMetadata(const QString &key, const QJsonValue &value)
 {
-    m_metadata.insert(key, value);
+    for (auto &entry : m_metadata) {
+        if (entry.first == key) {
+            entry.second = value;
+            return;
+        }
+    }
+    m_metadata.append({StringInterner::intern(key), value});
 }
 
 QJsonValue AbstractResource::getMetadata(const QString &key)
 {
-    return m_metadata.value(key);
+    for (const auto &entry : qAsConst(m_metadata)) {
+        if (entry.first == key)
+            return entry.second;
+    }
+    return QJsonValue::Undefined;
 }
 
 bool AbstractResource::canUpgrade()
@@ -104,11 +118,27 @@ QString AbstractResource::sizeDescription()
 QCollatorSortKey AbstractResource::nameSortKey()
 {
     if (!m_collatorKey) {
-        m_collatorKey.reset(new QCollatorSortKey(QCollator().sortKey(name())));
+        m_collatorKey.reset(new QCollatorSortKey(Collation::sortKey(name())));
     }
     return *m_collatorKey;
 }
 
+void AbstractResource::prepareNameSortKeys(const QVector<AbstractResource *> &resources)
+{
+    const auto pending = kFilter<QVector<AbstractResource *>>(resources, [](AbstractResource *res) {
+        return !res->m_collatorKey;
+    });
+    if (pending.isEmpty())
+        return;
+
+    // name() can't be called from other threads, only the keys are generated there
+    const auto keys = Collation::sortKeys(kTransform<QStringList>(pending, [](AbstractResource *res) {
+        return res->name();
+    }));
+    for (int i = 0, c = pending.count(); i < c; ++i)
+        pending[i]->m_collatorKey.reset(new QCollatorSortKey(keys[i]));
+}
+
 Rating *AbstractResource::rating() const
 {
     AbstractReviewsBackend *ratings = backend()->reviewsBackend();
@@ -137,63 +167,25 @@ void AbstractResource::reportNewState()
         return;
 
     static const QVector<QByteArray> ns = {"state", "status", "canUpgrade", "size", "sizeDescription", "installedVersion", "availableVersion"};
-    emit backend()->resourcesChanged(this, ns);
+    backend()->reportResourceChanged(this, ns);
 }
 
-static bool shouldFilter(AbstractResource *res, const QPair<FilterType, QString> &filter)
+bool AbstractResource::categoryMatches(Category *cat)
 {
-    bool ret = true;
-    switch (filter.first) {
-    case CategoryFilter:
-        ret = res->categories().contains(filter.second);
-        break;
-    case PkgSectionFilter:
-        ret = res->section() == filter.second;
-        break;
-    case PkgWildcardFilter: {
-        QString wildcard = filter.second;
-        wildcard.remove(QLatin1Char('*'));
-        ret = res->packageName().contains(wildcard);
-    } break;
-    case AppstreamIdWildcardFilter: {
-        QString wildcard = filter.second;
-        wildcard.remove(QLatin1Char('*'));
-        ret = res->appstreamId().contains(wildcard);
-    } break;
-    case PkgNameFilter: // Only useful in the not filters
-        ret = res->packageName() == filter.second;
-        break;
-    case InvalidFilter:
-        break;
-    }
-    return ret;
+    return cat->matcher()->matches(this);
 }
 
-bool AbstractResource::categoryMatches(Category *cat)
+const QVector<int> &AbstractResource::categoryIds()
 {
-    {
-        const auto orFilters = cat->orFilters();
-        bool orValue = orFilters.isEmpty();
-        for (const auto &filter : orFilters) {
-            if (shouldFilter(this, filter)) {
-                orValue = true;
-                break;
-            }
-        }
-        if (!orValue)
-            return false;
-    }
-
-    Q_FOREACH (const auto &filter, cat->andFilters()) {
-        if (!shouldFilter(this, filter))
-            return false;
-    }
-
-    Q_FOREACH (const auto &filter, cat->notFilters()) {
-        if (shouldFilter(this, filter))
-            return false;
+    if (!m_categoryIdsInitialized) {
+        const auto cats = categories();
+        m_categoryIds = kTransform<QVector<int>>(cats, [](const QString &name) {
+            return CategoryMatcher::internCategory(name);
+        });
+        std::sort(m_categoryIds.begin(), m_categoryIds.end());
+        m_categoryIdsInitialized = true;
     }
-    return true;
+    return m_categoryIds;
 }
 
 static QSet<Category *> walkCategories(AbstractResource *res, const QVector<Category *> &cats)
@@ -268,3 +260,16 @@ QString AbstractResource::upgradeText() const
         return available;
     }
 }
+
+size_t AbstractResource::memoryFootprint() const
+{
+    size_t ret = sizeof(AbstractResource) + m_categoryIds.capacity() * sizeof(int);
+    if (m_collatorKey)
+        ret += sizeof(QCollatorSortKey);
+    for (const auto &entry : m_metadata) {
+        ret += sizeof(entry) + StringInterner::footprint(entry.first);
+        if (entry.second.isString())
+            ret += entry.second.toString().size() * sizeof(QChar);
+    }
+    return ret;
+}
@@ -179,6 +179,14 @@ public:
      */
     QCollatorSortKey nameSortKey();
 
+    /**
+     * Generates the name sort keys of @p resources that don't have one yet, all in one batch.
+     * Call it before sorting many resources by name.
+     *
+     * @sa Collation
+     */
+    static void prepareNameSortKeys(const QVector<AbstractResource *> &resources);
+
     /**
      * Convenience method to fetch the resource's rating
      *
@@ -194,6 +202,14 @@ public:
 
     bool categoryMatches(Category *cat);
 
+    /**
+     * @returns the sorted interned ids of categories(), computed the first time it's needed
+     * so categories() is expected to stay the same during the lifetime of the resource.
+     *
+     * @sa CategoryMatcher::internCategory
+     */
+    const QVector<int> &categoryIds();
+
     QSet<Category *> categoryObjects(const QVector<Category *> &cats) const;
 
     /**
@@ -215,6 +231,14 @@ public:
 
     virtual QString upgradeText() const;
 
+    /**
+     * @returns an estimate of the heap memory held by the resource, in bytes.
+     *
+     * Backends should add the data they keep on top of the base implementation.
+     * Strings shared with other resources (see StringInterner) aren't accounted for.
+     */
+    virtual size_t memoryFootprint() const;
+
 public Q_SLOTS:
     virtual void fetchScreenshots();
     virtual void fetchChangelog() = 0;
@@ -241,7 +265,10 @@ private:
 
     //     TODO: make it std::optional or make QCollatorSortKey()
     QScopedPointer<QCollatorSortKey> m_collatorKey;
-    QJsonObject m_metadata;
+    QVector<int> m_categoryIds;
+    bool m_categoryIdsInitialized = false;
+    // Only a handful of resources get metadata, and then only a couple of keys
+    QVector<QPair<QString, QJsonValue>> m_metadata;
 };
 
 Q_DECLARE_METATYPE(QVector<AbstractResource *>)
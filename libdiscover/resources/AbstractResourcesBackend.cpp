@@ -10,7 +10,9 @@
 #include <QHash>
 #include <QMetaObject>
 #include <QMetaProperty>
+#include <QSharedPointer>
 #include <QTimer>
+#include <algorithm>
 
 QDebug operator<<(QDebug debug, const AbstractResourcesBackend::Filters &filters)
 {
@@ -65,7 +67,12 @@ void ResultsStream::finish()
 
 AbstractResourcesBackend::AbstractResourcesBackend(QObject *parent)
     : QObject(parent)
+    , m_changedResourcesTimer(new QTimer(this))
 {
+    m_changedResourcesTimer->setSingleShot(true);
+    m_changedResourcesTimer->setInterval(0);
+    connect(m_changedResourcesTimer, &QTimer::timeout, this, &AbstractResourcesBackend::flushChangedResources);
+
     QTimer *fetchingChangedTimer = new QTimer(this);
     fetchingChangedTimer->setInterval(3000);
     fetchingChangedTimer->setSingleShot(true);
@@ -104,6 +111,31 @@ void AbstractResourcesBackend::emitRatingsReady()
     emit allDataChanged({"rating", "ratingPoints", "ratingCount", "sortableRating"});
 }
 
+void AbstractResourcesBackend::reportResourceChanged(AbstractResource *resource, const QVector<QByteArray> &properties)
+{
+    m_changedResources[properties] += resource;
+    m_changedResourcesTimer->start();
+}
+
+void AbstractResourcesBackend::flushChangedResources()
+{
+    const auto changed = qExchange(m_changedResources, {});
+    for (auto it = changed.constBegin(), itEnd = changed.constEnd(); it != itEnd; ++it) {
+        QVector<AbstractResource *> resources;
+        resources.reserve(it->count());
+        for (const auto &resource : *it) {
+            if (resource)
+                resources += resource;
+        }
+
+        // A resource usually changes more than once while it's being processed
+        std::sort(resources.begin(), resources.end());
+        resources.erase(std::unique(resources.begin(), resources.end()), resources.end());
+        if (!resources.isEmpty())
+            Q_EMIT resourcesChanged(resources, it.key());
+    }
+}
+
 bool AbstractResourcesBackend::Filters::shouldFilter(AbstractResource *res) const
 {
     Q_ASSERT(res);
@@ -137,6 +169,29 @@ void AbstractResourcesBackend::Filters::filterJustInCase(QVector<AbstractResourc
     }
 }
 
+ResultsStream *AbstractResourcesBackend::findResourcesByUrls(const QVector<QUrl> &urls)
+{
+    auto stream = new ResultsStream(QLatin1String("ResourcesByUrls-") + name());
+    if (urls.isEmpty()) {
+        QTimer::singleShot(0, stream, &ResultsStream::finish);
+        return stream;
+    }
+
+    auto pending = QSharedPointer<int>::create(urls.count());
+    for (const QUrl &url : urls) {
+        Filters filter;
+        filter.resourceUrl = url;
+        auto urlStream = search(filter);
+        connect(urlStream, &ResultsStream::resourcesFound, stream, &ResultsStream::resourcesFound);
+        connect(urlStream, &QObject::destroyed, stream, [stream, pending] {
+            --*pending;
+            if (*pending == 0)
+                stream->finish();
+        });
+    }
+    return stream;
+}
+
 QStringList AbstractResourcesBackend::extends() const
 {
     return {};
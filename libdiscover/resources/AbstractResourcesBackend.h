@@ -7,8 +7,10 @@
 #ifndef ABSTRACTRESOURCESBACKEND_H
 #define ABSTRACTRESOURCESBACKEND_H
 
+#include <QHash>
 #include <QObject>
 #include <QPair>
+#include <QPointer>
 #include <QVector>
 
 #include "AbstractResource.h"
@@ -20,6 +22,7 @@ class Transaction;
 class Category;
 class AbstractReviewsBackend;
 class AbstractBackendUpdater;
+class QTimer;
 
 class DISCOVERCOMMON_EXPORT ResultsStream : public QObject
 {
@@ -106,6 +109,17 @@ public:
 
     virtual ResultsStream *search(const Filters &search) = 0; // FIXME: Probably provide a standard implementation?!
 
+    /**
+     * Looks up the resources for many urls (usually appstream://) at once.
+     *
+     * Resources are offered as soon as they are found, in no specific order. The default
+     * implementation runs a search() per url, backends that can resolve them through an
+     * index should override it.
+     *
+     * @returns a stream that will provide the resources the @p urls refer to
+     */
+    virtual ResultsStream *findResourcesByUrls(const QVector<QUrl> &urls);
+
     /**
      * @returns the reviews backend of this AbstractResourcesBackend (which handles all ratings and reviews of resources)
      */
@@ -153,6 +167,14 @@ public:
      */
     void emitRatingsReady();
 
+    /**
+     * Reports that some @p properties in @p resource have changed.
+     *
+     * The reports are gathered and emitted together through resourcesChanged() once
+     * the event loop gets to them, one batch for every list of properties.
+     */
+    void reportResourceChanged(AbstractResource *resource, const QVector<QByteArray> &properties);
+
     /**
      * @returns the root category tree
      */
@@ -217,16 +239,22 @@ Q_SIGNALS:
     void allDataChanged(const QVector<QByteArray> &propertyNames);
 
     /**
-     * Allows to notify some @p properties in @p resource have changed
+     * Notifies that some @p properties in all of @p resources have changed
+     *
+     * @see reportResourceChanged()
      */
-    void resourcesChanged(AbstractResource *resource, const QVector<QByteArray> &properties);
+    void resourcesChanged(const QVector<AbstractResource *> &resources, const QVector<QByteArray> &properties);
     void resourceRemoved(AbstractResource *resource);
 
     void passiveMessage(const QString &message);
     void fetchingUpdatesProgressChanged();
 
 private:
+    void flushChangedResources();
+
     QString m_name;
+    QHash<QVector<QByteArray>, QVector<QPointer<AbstractResource>>> m_changedResources;
+    QTimer *const m_changedResourcesTimer;
 };
 
 DISCOVERCOMMON_EXPORT QDebug operator<<(QDebug dbg, const AbstractResourcesBackend::Filters &filters);
@@ -0,0 +1,38 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "Collation.h"
+#include <QCollator>
+#include <QThreadStorage>
+#include <QtConcurrentMap>
+
+// Below this many strings, handing them to other threads costs more than it saves
+static const int s_parallelThreshold = 1000;
+
+QCollator *Collation::collator()
+{
+    static QThreadStorage<QCollator *> s_collators;
+    if (!s_collators.hasLocalData())
+        s_collators.setLocalData(new QCollator);
+    return s_collators.localData();
+}
+
+QCollatorSortKey Collation::sortKey(const QString &string)
+{
+    return collator()->sortKey(string);
+}
+
+QVector<QCollatorSortKey> Collation::sortKeys(const QStringList &strings)
+{
+    if (strings.size() >= s_parallelThreshold)
+        return QtConcurrent::blockingMapped<QVector<QCollatorSortKey>>(strings, &Collation::sortKey);
+
+    QVector<QCollatorSortKey> ret;
+    ret.reserve(strings.size());
+    for (const QString &string : strings)
+        ret.append(sortKey(string));
+    return ret;
+}
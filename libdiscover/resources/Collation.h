@@ -0,0 +1,37 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#ifndef COLLATION_H
+#define COLLATION_H
+
+#include "discovercommon_export.h"
+#include <QCollatorSortKey>
+#include <QStringList>
+#include <QVector>
+
+class QCollator;
+
+/**
+ * \class Collation  Collation.h "Collation.h"
+ *
+ * \brief Locale-aware sort keys shared by every model that sorts by name.
+ *
+ * Creating a QCollator is expensive, so each thread creates one the first time
+ * it needs it and reuses it afterwards.
+ */
+class DISCOVERCOMMON_EXPORT Collation
+{
+public:
+    /// @returns the collator of the calling thread
+    static QCollator *collator();
+
+    static QCollatorSortKey sortKey(const QString &string);
+
+    /// @returns the sort keys of @p strings, in order. Big batches are spread over the global thread pool.
+    static QVector<QCollatorSortKey> sortKeys(const QStringList &strings);
+};
+
+#endif // COLLATION_H
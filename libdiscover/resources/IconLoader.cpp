@@ -0,0 +1,118 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "IconLoader.h"
+#include "AbstractResource.h"
+#include "libdiscover_debug.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+Q_GLOBAL_STATIC(IconLoader, globalIconLoader)
+
+// Same as the connections QNetworkAccessManager opens per host
+static const int s_maxDownloads = 6;
+
+IconLoader::IconLoader(QObject *parent)
+    : IconLoader(new QNetworkAccessManager, parent)
+{
+}
+
+IconLoader::IconLoader(QNetworkAccessManager *nam, QObject *parent)
+    : QObject(parent)
+    , m_nam(nam)
+    , m_icons(1000)
+{
+    m_nam->setParent(this);
+    m_nam->setRedirectPolicy(QNetworkRequest::NoLessSafeRedirectPolicy);
+    connect(m_nam, &QNetworkAccessManager::finished, this, &IconLoader::downloadFinished);
+}
+
+IconLoader::~IconLoader() = default;
+
+IconLoader *IconLoader::global()
+{
+    return globalIconLoader;
+}
+
+QString IconLoader::cachePath(const QUrl &url)
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/icons/") + url.fileName();
+}
+
+QIcon IconLoader::icon(const QString &key, const std::function<QIcon()> &build)
+{
+    if (QIcon *cached = m_icons.object(key))
+        return *cached;
+
+    m_missedFetch = false;
+    const QIcon ret = build();
+    if (!m_missedFetch && !ret.isNull())
+        m_icons.insert(key, new QIcon(ret));
+    m_missedFetch = false;
+    return ret;
+}
+
+QString IconLoader::fetchRemote(const QUrl &url, AbstractResource *resource)
+{
+    const QString path = cachePath(url);
+    if (QFileInfo::exists(path))
+        return path;
+    if (m_failed.contains(url))
+        return {};
+
+    m_missedFetch = true;
+    auto it = m_waiting.find(url);
+    if (it == m_waiting.end()) {
+        // Last asked goes first, the ones asked before have likely scrolled away already
+        it = m_waiting.insert(url, {});
+        m_queue.append(url);
+        startDownloads();
+    }
+    if (!it->contains(resource))
+        it->append(resource);
+    return {};
+}
+
+void IconLoader::startDownloads()
+{
+    while (m_running < s_maxDownloads && !m_queue.isEmpty()) {
+        ++m_running;
+        m_nam->get(QNetworkRequest(m_queue.takeLast()));
+    }
+}
+
+void IconLoader::downloadFinished(QNetworkReply *reply)
+{
+    reply->deleteLater();
+    --m_running;
+
+    const QUrl url = reply->request().url();
+    const auto resources = m_waiting.take(url);
+    if (reply->error() != QNetworkReply::NoError) {
+        qCWarning(LIBDISCOVER_LOG) << "could not fetch icon" << url << reply->errorString();
+        m_failed.insert(url);
+    } else {
+        const QString path = cachePath(url);
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        // Written aside and renamed, other instances never see a partial icon
+        QSaveFile file(path);
+        if (file.open(QIODevice::WriteOnly) && file.write(reply->readAll()) >= 0 && file.commit()) {
+            for (const auto &resource : resources) {
+                if (resource)
+                    Q_EMIT resource->iconChanged();
+            }
+        } else {
+            qCWarning(LIBDISCOVER_LOG) << "could not store icon" << path << file.errorString();
+            m_failed.insert(url);
+        }
+    }
+    startDownloads();
+}
@@ -0,0 +1,79 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#ifndef ICONLOADER_H
+#define ICONLOADER_H
+
+#include "discovercommon_export.h"
+#include <QCache>
+#include <QHash>
+#include <QIcon>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QUrl>
+#include <QVector>
+#include <functional>
+
+class AbstractResource;
+class QNetworkAccessManager;
+class QNetworkReply;
+
+/**
+ * \class IconLoader  IconLoader.h "IconLoader.h"
+ *
+ * \brief Fetches and caches the icons of the resources.
+ *
+ * Remote icons are only downloaded once a resource's icon is asked for, which is when
+ * a view is about to show it. Downloads share one connection pool, a few at a time and
+ * most recent requests first, and every url is only downloaded once no matter how many
+ * resources need it. They are kept on disk so they're available on the next run.
+ *
+ * The icons resources build out of their files are kept in memory for the ones used last,
+ * so they don't need to look for the files every time a delegate asks for them.
+ */
+class DISCOVERCOMMON_EXPORT IconLoader : public QObject
+{
+    Q_OBJECT
+public:
+    explicit IconLoader(QObject *parent = nullptr);
+    /// Downloads through @p nam, which the loader takes ownership of
+    explicit IconLoader(QNetworkAccessManager *nam, QObject *parent = nullptr);
+    ~IconLoader() override;
+
+    static IconLoader *global();
+
+    /**
+     * @returns the icon identified by @p key, calling @p build to create it if it's not in memory.
+     *
+     * Icons that were still waiting for a fetchRemote() call when built aren't kept, and neither are null
+     * icons, so resources can show a fallback until their files are there.
+     */
+    QIcon icon(const QString &key, const std::function<QIcon()> &build);
+
+    /**
+     * @returns the local file for @p url if it's downloaded already. Otherwise returns an empty string,
+     * downloads it and emits @p resource's iconChanged() once it's available.
+     */
+    QString fetchRemote(const QUrl &url, AbstractResource *resource);
+
+    /// @returns where @p url gets stored on disk
+    static QString cachePath(const QUrl &url);
+
+private:
+    void startDownloads();
+    void downloadFinished(QNetworkReply *reply);
+
+    QNetworkAccessManager *const m_nam;
+    QCache<QString, QIcon> m_icons;
+    QHash<QUrl, QVector<QPointer<AbstractResource>>> m_waiting;
+    QVector<QUrl> m_queue;
+    QSet<QUrl> m_failed;
+    int m_running = 0;
+    bool m_missedFetch = false;
+};
+
+#endif // ICONLOADER_H
@@ -15,11 +15,13 @@
 #include "utils.h"
 #include <DiscoverBackendsFactory.h>
 #include <KConfigGroup>
+#include <KFormat>
 #include <KLocalizedString>
 #include <KSharedConfig>
 #include <QCoreApplication>
 #include <QIcon>
 #include <QMetaProperty>
+#include <QTextStream>
 #include <QThread>
 #include <ReviewsBackend/AbstractReviewsBackend.h>
 #include <ReviewsBackend/Rating.h>
@@ -417,3 +419,21 @@ QString ResourcesModel::applicationSourceName() const
     KConfigGroup settings(KSharedConfig::openConfig(), "ResourcesModel");
     return settings.readEntry<QString>("currentApplicationBackend", QStringLiteral("packagekit-backend"));
 }
+
+QString ResourcesModel::memoryReport() const
+{
+    QString ret;
+    QTextStream stream(&ret);
+    for (AbstractResourcesBackend *backend : m_backends) {
+        const auto resources = backend->findChildren<AbstractResource *>(QString(), Qt::FindDirectChildrenOnly);
+        size_t total = 0;
+        for (AbstractResource *res : resources)
+            total += res->memoryFootprint();
+
+        stream << backend->name() << ": " << resources.count() << " resources, " << KFormat().formatByteSize(total);
+        if (!resources.isEmpty())
+            stream << ", " << total / resources.count() << " bytes per resource";
+        stream << '\n';
+    }
+    return ret;
+}
@@ -116,6 +116,9 @@ public:
         return m_fetchingUpdatesProgress.m_value;
     }
 
+    /// @returns a summary of the memory held by the resources of each backend, see AbstractResource::memoryFootprint()
+    QString memoryReport() const;
+
 public Q_SLOTS:
     void installApplication(AbstractResource *app, const AddonList &addons);
     void installApplication(AbstractResource *app);
@@ -127,7 +130,7 @@ Q_SIGNALS:
     void backendsChanged();
     void updatesCountChanged(int updatesCount);
     void backendDataChanged(AbstractResourcesBackend *backend, const QVector<QByteArray> &properties);
-    void resourceDataChanged(AbstractResource *resource, const QVector<QByteArray> &properties);
+    void resourceDataChanged(const QVector<AbstractResource *> &resources, const QVector<QByteArray> &properties);
     void resourceRemoved(AbstractResource *resource);
     void passiveMessage(const QString &message);
     void currentApplicationBackendChanged(AbstractResourcesBackend *currentApplicationBackend);
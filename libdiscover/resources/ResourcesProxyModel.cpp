@@ -49,7 +49,7 @@ ResourcesProxyModel::ResourcesProxyModel(QObject *parent)
 
     connect(ResourcesModel::global(), &ResourcesModel::backendsChanged, this, &ResourcesProxyModel::invalidateFilter);
     connect(ResourcesModel::global(), &ResourcesModel::backendDataChanged, this, &ResourcesProxyModel::refreshBackend);
-    connect(ResourcesModel::global(), &ResourcesModel::resourceDataChanged, this, &ResourcesProxyModel::refreshResource);
+    connect(ResourcesModel::global(), &ResourcesModel::resourceDataChanged, this, &ResourcesProxyModel::refreshResources);
     connect(ResourcesModel::global(), &ResourcesModel::resourceRemoved, this, &ResourcesProxyModel::removeResource);
 
     connect(this, &QAbstractItemModel::modelReset, this, &ResourcesProxyModel::countChanged);
@@ -109,100 +109,69 @@ void ResourcesProxyModel::setSearch(const QString &_searchText)
 void ResourcesProxyModel::removeDuplicates(QVector<AbstractResource *> &resources)
 {
     const auto cab = ResourcesModel::global()->currentApplicationBackend();
+
+    // The displayed resources are indexed already, only the new ones need to be gathered
     QHash<QString, QString> aliases;
-    QHash<QString, QVector<AbstractResource *>::iterator> storedIds;
-    for (auto it = m_displayedResources.begin(); it != m_displayedResources.end(); ++it) {
-        const auto appstreamid = (*it)->appstreamId();
+    QHash<QString, int> ids;
+    const auto aliasOf = [this, &aliases](const QString &id) {
+        const auto it = aliases.constFind(id);
+        return it != aliases.constEnd() ? *it : m_aliases.value(id);
+    };
+    const auto displayedWithId = [this, &aliasOf](const QString &id) {
+        AbstractResource *ret = m_displayedIds.value(id);
+        return ret ? ret : m_displayedIds.value(aliasOf(id));
+    };
+    const auto newWithId = [&ids, &aliasOf](const QString &id) {
+        return ids.value(id, ids.value(aliasOf(id), -1));
+    };
+
+    for (int i = 0; i < resources.count();) {
+        AbstractResource *res = resources[i];
+        const auto appstreamid = res->appstreamId();
         if (appstreamid.isEmpty()) {
+            ++i;
             continue;
         }
-        auto at = storedIds.find(appstreamid);
-        if (at == storedIds.end()) {
-            storedIds[appstreamid] = it;
-        } else {
-            qCWarning(LIBDISCOVER_LOG) << "We should have sanitized the displayed resources. There is a bug";
-            Q_UNREACHABLE();
-        }
 
-        const auto alts = (*it)->alternativeAppstreamIds();
-        for (const auto &alias : alts) {
-            aliases[alias] = appstreamid;
+        AbstractResource *displayed = displayedWithId(appstreamid);
+        if (!displayed) {
+            const auto alts = res->alternativeAppstreamIds();
+            for (auto it = alts.constBegin(); !displayed && it != alts.constEnd(); ++it) {
+                displayed = displayedWithId(*it);
+            }
         }
-    }
 
-    QHash<QString, QVector<AbstractResource *>::iterator> ids;
-    for (auto it = resources.begin(); it != resources.end();) {
-        const auto appstreamid = (*it)->appstreamId();
-        if (appstreamid.isEmpty()) {
-            ++it;
-            continue;
-        }
-        auto at = storedIds.find(appstreamid);
-        if (at == storedIds.end()) {
-            auto aliased = aliases.constFind(appstreamid);
-            if (aliased != aliases.constEnd()) {
-                at = storedIds.find(aliased.value());
+        if (displayed) {
+            const int row = rowOf(displayed);
+            if (res->backend() == cab && row >= 0) {
+                replaceResource(row, res);
+                const auto pos = index(row, 0);
+                Q_EMIT dataChanged(pos, pos);
             }
+            resources.removeAt(i);
+            continue;
         }
 
-        if (at == storedIds.end()) {
-            const auto alts = (*it)->alternativeAppstreamIds();
-            for (const auto &alt : alts) {
-                at = storedIds.find(alt);
-                if (at == storedIds.end())
-                    break;
-
-                auto aliased = aliases.constFind(alt);
-                if (aliased != aliases.constEnd()) {
-                    at = storedIds.find(aliased.value());
-                    if (at != storedIds.end())
-                        break;
-                }
+        int at = newWithId(appstreamid);
+        if (at < 0) {
+            const auto alts = res->alternativeAppstreamIds();
+            for (auto it = alts.constBegin(); at < 0 && it != alts.constEnd(); ++it) {
+                at = newWithId(*it);
             }
         }
-        if (at == storedIds.end()) {
-            auto at = ids.find(appstreamid);
-            if (at == ids.end()) {
-                auto aliased = aliases.constFind(appstreamid);
-                if (aliased != aliases.constEnd()) {
-                    at = ids.find(aliased.value());
-                }
-            }
-            if (at == ids.end()) {
-                const auto alts = (*it)->alternativeAppstreamIds();
-                for (const auto &alt : alts) {
-                    at = ids.find(alt);
-                    if (at != ids.end())
-                        break;
-
-                    auto aliased = aliases.constFind(appstreamid);
-                    if (aliased != aliases.constEnd()) {
-                        at = ids.find(aliased.value());
-                        if (at != ids.end())
-                            break;
-                    }
-                }
-            }
-            if (at == ids.end()) {
-                ids[appstreamid] = it;
-                const auto alts = (*it)->alternativeAppstreamIds();
-                for (const auto &alias : alts) {
-                    aliases[alias] = appstreamid;
-                }
-                ++it;
-            } else {
-                if ((*it)->backend() == cab) {
-                    qSwap(*it, **at);
-                }
-                it = resources.erase(it);
+
+        if (at < 0) {
+            ids[appstreamid] = i;
+            const auto alts = res->alternativeAppstreamIds();
+            for (const auto &alias : alts) {
+                aliases[alias] = appstreamid;
             }
+            ++i;
         } else {
-            if ((*it)->backend() == cab) {
-                **at = *it;
-                auto pos = index(*at - m_displayedResources.begin(), 0);
-                Q_EMIT dataChanged(pos, pos);
+            if (res->backend() == cab) {
+                qSwap(resources[i], resources[at]);
             }
-            it = resources.erase(it);
+            resources.removeAt(i);
         }
     }
 }
@@ -215,10 +184,12 @@ void ResourcesProxyModel::addResources(const QVector<AbstractResource *> &_res)
     if (res.isEmpty())
         return;
 
-    if (!m_sortByRelevancy)
+    if (!m_sortByRelevancy) {
+        AbstractResource::prepareNameSortKeys(res);
         std::sort(res.begin(), res.end(), [this](AbstractResource *res, AbstractResource *res2) {
             return lessThan(res, res2);
         });
+    }
 
     sortedInsertion(res);
     fetchSubcategories();
@@ -230,10 +201,15 @@ void ResourcesProxyModel::invalidateSorting()
         return;
 
     if (!m_sortByRelevancy) {
+        AbstractResource::prepareNameSortKeys(m_displayedResources);
         beginResetModel();
         std::sort(m_displayedResources.begin(), m_displayedResources.end(), [this](AbstractResource *res, AbstractResource *res2) {
             return lessThan(res, res2);
         });
+        for (int row = 0, count = m_displayedResources.count(); row < count; ++row) {
+            m_rows[m_displayedResources[row]] = row;
+        }
+        m_firstMovedRow = std::numeric_limits<int>::max();
         endResetModel();
     }
 }
@@ -312,6 +288,10 @@ void ResourcesProxyModel::invalidateFilter()
     if (!m_displayedResources.isEmpty()) {
         beginResetModel();
         m_displayedResources.clear();
+        m_rows.clear();
+        m_firstMovedRow = std::numeric_limits<int>::max();
+        m_displayedIds.clear();
+        m_aliases.clear();
         endResetModel();
     }
 
@@ -518,7 +498,11 @@ void ResourcesProxyModel::sortedInsertion(const QVector<AbstractResource *> &_re
         // Q_ASSERT(m_sortByRelevancy || isSorted(resources));
         int rows = rowCount();
         beginInsertRows({}, rows, rows + resources.count() - 1);
-        m_displayedResources += resources;
+        m_displayedResources.reserve(rows + resources.count());
+        for (AbstractResource *resource : qAsConst(resources)) {
+            addToIndex(resource, m_displayedResources.count());
+            m_displayedResources += resource;
+        }
         endInsertRows();
         return;
     }
@@ -535,48 +519,180 @@ void ResourcesProxyModel::sortedInsertion(const QVector<AbstractResource *> &_re
 
         beginInsertRows({}, newIdx, newIdx);
         m_displayedResources.insert(newIdx, resource);
+        markRowsMoved(newIdx);
+        addToIndex(resource, newIdx);
         endInsertRows();
         // Q_ASSERT(isSorted(resources));
     }
 }
 
-void ResourcesProxyModel::refreshResource(AbstractResource *resource, const QVector<QByteArray> &properties)
+void ResourcesProxyModel::refreshResources(const QVector<AbstractResource *> &resources, const QVector<QByteArray> &properties)
 {
-    const auto residx = m_displayedResources.indexOf(resource);
-    if (residx < 0) {
+    if (m_displayedResources.isEmpty())
         return;
+
+    const auto roles = propertiesToRoles(properties);
+    const bool resort = !m_sortByRelevancy && roles.contains(m_sortRole);
+
+    QVector<int> changedRows;
+    QVector<int> removedRows;
+    QVector<AbstractResource *> reinserted;
+    for (AbstractResource *resource : resources) {
+        const int row = rowOf(resource);
+        if (row < 0)
+            continue;
+
+        if (!m_filters.shouldFilter(resource)) {
+            removedRows += row;
+        } else if (resort) {
+            removedRows += row;
+            reinserted += resource;
+        } else {
+            changedRows += row;
+        }
     }
 
-    if (!m_filters.shouldFilter(resource)) {
-        beginRemoveRows({}, residx, residx);
-        m_displayedResources.removeAt(residx);
-        endRemoveRows();
+    // The usual case, a single resource changed: move it rather than removing and inserting it again
+    if (reinserted.count() == 1 && removedRows.count() == 1 && changedRows.isEmpty()) {
+        moveToSortedRow(removedRows.constFirst(), roles);
         return;
     }
+    std::sort(changedRows.begin(), changedRows.end());
+    std::sort(removedRows.begin(), removedRows.end());
 
-    const QModelIndex idx = index(residx, 0);
-    Q_ASSERT(idx.isValid());
-    const auto roles = propertiesToRoles(properties);
-    if (!m_sortByRelevancy && roles.contains(m_sortRole)) {
-        beginRemoveRows({}, residx, residx);
-        m_displayedResources.removeAt(residx);
-        endRemoveRows();
+    for (const auto &range : kRowRanges(changedRows)) {
+        Q_EMIT dataChanged(index(range.first, 0), index(range.second, 0), roles);
+    }
+
+    // From the bottom up, so the rows still to be removed keep their position
+    const auto removedRanges = kRowRanges(removedRows);
+    for (auto it = removedRanges.crbegin(), itEnd = removedRanges.crend(); it != itEnd; ++it) {
+        removeDisplayed(it->first, it->second);
+    }
+
+    if (!reinserted.isEmpty()) {
+        std::sort(reinserted.begin(), reinserted.end(), [this](AbstractResource *res, AbstractResource *res2) {
+            return lessThan(res, res2);
+        });
+        sortedInsertion(reinserted);
+    }
+}
+
+void ResourcesProxyModel::moveToSortedRow(int from, const QVector<int> &roles)
+{
+    AbstractResource *resource = m_displayedResources[from];
+    const auto finder = [this](AbstractResource *resource, AbstractResource *res) {
+        return lessThan(resource, res);
+    };
+    const auto begin = m_displayedResources.constBegin();
+    const int count = m_displayedResources.count();
 
-        sortedInsertion({resource});
-    } else
-        emit dataChanged(idx, idx, roles);
+    // The rest of the list is still sorted, so we only need to look on the side it has to go to
+    int to = from;
+    int destination = from;
+    if (from > 0 && lessThan(resource, m_displayedResources[from - 1])) {
+        to = std::upper_bound(begin, begin + from, resource, finder) - begin;
+        destination = to;
+    } else if (from + 1 < count && lessThan(m_displayedResources[from + 1], resource)) {
+        destination = std::upper_bound(begin + from + 1, m_displayedResources.constEnd(), resource, finder) - begin;
+        to = destination - 1;
+    }
+
+    if (to != from) {
+        beginMoveRows({}, from, from, {}, destination);
+        m_displayedResources.move(from, to);
+        // Only the rows in between shift, the others stay where they were
+        for (int row = qMin(from, to), last = qMax(from, to); row <= last; ++row) {
+            m_rows[m_displayedResources[row]] = row;
+        }
+        endMoveRows();
+    }
+
+    const auto pos = index(to, 0);
+    Q_EMIT dataChanged(pos, pos, roles);
 }
 
 void ResourcesProxyModel::removeResource(AbstractResource *resource)
 {
-    const auto residx = m_displayedResources.indexOf(resource);
+    const auto residx = rowOf(resource);
     if (residx < 0)
         return;
-    beginRemoveRows({}, residx, residx);
-    m_displayedResources.removeAt(residx);
+    removeDisplayed(residx, residx);
+}
+
+void ResourcesProxyModel::removeDisplayed(int first, int last)
+{
+    beginRemoveRows({}, first, last);
+    for (int row = first; row <= last; ++row) {
+        removeFromIndex(m_displayedResources[row]);
+    }
+    m_displayedResources.remove(first, last - first + 1);
+    markRowsMoved(first);
     endRemoveRows();
 }
 
+void ResourcesProxyModel::replaceResource(int row, AbstractResource *resource)
+{
+    removeFromIndex(m_displayedResources[row]);
+    m_displayedResources[row] = resource;
+    addToIndex(resource, row);
+}
+
+void ResourcesProxyModel::addToIndex(AbstractResource *resource, int row)
+{
+    m_rows.insert(resource, row);
+
+    const auto appstreamid = resource->appstreamId();
+    if (appstreamid.isEmpty())
+        return;
+    m_displayedIds.insert(appstreamid, resource);
+    const auto alts = resource->alternativeAppstreamIds();
+    for (const auto &alias : alts) {
+        m_aliases.insert(alias, appstreamid);
+    }
+}
+
+void ResourcesProxyModel::removeFromIndex(AbstractResource *resource)
+{
+    m_rows.remove(resource);
+
+    const auto appstreamid = resource->appstreamId();
+    const auto it = m_displayedIds.find(appstreamid);
+    if (it == m_displayedIds.end() || *it != resource)
+        return;
+    m_displayedIds.erase(it);
+    const auto alts = resource->alternativeAppstreamIds();
+    for (const auto &alias : alts) {
+        const auto aliasIt = m_aliases.find(alias);
+        if (aliasIt != m_aliases.end() && *aliasIt == appstreamid)
+            m_aliases.erase(aliasIt);
+    }
+}
+
+void ResourcesProxyModel::markRowsMoved(int first)
+{
+    // The rows before are where they were, the rest is reindexed in one go once needed
+    m_firstMovedRow = qMin(m_firstMovedRow, first);
+}
+
+int ResourcesProxyModel::rowOf(AbstractResource *resource) const
+{
+    const auto it = m_rows.constFind(resource);
+    if (it == m_rows.constEnd())
+        return -1;
+    if (*it < m_firstMovedRow)
+        return *it;
+
+    for (int row = m_firstMovedRow, count = m_displayedResources.count(); row < count; ++row) {
+        m_rows[m_displayedResources[row]] = row;
+    }
+    m_firstMovedRow = std::numeric_limits<int>::max();
+
+    const int row = m_rows.value(resource);
+    Q_ASSERT(m_displayedResources[row] == resource);
+    return row;
+}
+
 void ResourcesProxyModel::refreshBackend(AbstractResourcesBackend *backend, const QVector<QByteArray> &properties)
 {
     auto roles = propertiesToRoles(properties);
@@ -612,7 +728,7 @@ QVector<int> ResourcesProxyModel::propertiesToRoles(const QVector<QByteArray> &p
 
 int ResourcesProxyModel::indexOf(AbstractResource *res)
 {
-    return m_displayedResources.indexOf(res);
+    return rowOf(res);
 }
 
 AbstractResource *ResourcesProxyModel::resourceAt(int row) const
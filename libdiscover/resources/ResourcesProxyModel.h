@@ -8,10 +8,12 @@
 #ifndef RESOURCESPROXYMODEL_H
 #define RESOURCESPROXYMODEL_H
 
+#include <QHash>
 #include <QQmlParserStatus>
 #include <QSortFilterProxyModel>
 #include <QString>
 #include <QStringList>
+#include <limits>
 
 #include <Category/Category.h>
 
@@ -132,11 +134,18 @@ public:
 
 private Q_SLOTS:
     void refreshBackend(AbstractResourcesBackend *backend, const QVector<QByteArray> &properties);
-    void refreshResource(AbstractResource *resource, const QVector<QByteArray> &properties);
+    void refreshResources(const QVector<AbstractResource *> &resources, const QVector<QByteArray> &properties);
     void removeResource(AbstractResource *resource);
 
 private:
     void sortedInsertion(const QVector<AbstractResource *> &res);
+    void removeDisplayed(int first, int last);
+    void replaceResource(int row, AbstractResource *resource);
+    void addToIndex(AbstractResource *resource, int row);
+    void removeFromIndex(AbstractResource *resource);
+    void markRowsMoved(int first);
+    void moveToSortedRow(int from, const QVector<int> &roles);
+    int rowOf(AbstractResource *resource) const;
     QVariant roleToValue(AbstractResource *res, int role) const;
 
     QVector<int> propertiesToRoles(const QVector<QByteArray> &properties) const;
@@ -155,6 +164,14 @@ private:
     QVariantList m_subcategories;
 
     QVector<AbstractResource *> m_displayedResources;
+
+    // Row of every displayed resource. Moves update the rows they shift, after insertions and removals
+    // the rows from m_firstMovedRow on are reindexed once asked for
+    mutable QHash<AbstractResource *, int> m_rows;
+    mutable int m_firstMovedRow = std::numeric_limits<int>::max();
+    // Displayed resources by appstream id, and the appstream ids of their alternative ids
+    QHash<QString, AbstractResource *> m_displayedIds;
+    QHash<QString, QString> m_aliases;
     const QHash<int, QByteArray> m_roles;
     AggregatedResultsStream *m_currentStream;
 
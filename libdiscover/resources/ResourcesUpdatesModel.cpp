@@ -17,10 +17,17 @@
 #include <KFormat>
 #include <KLocalizedString>
 #include <KSharedConfig>
+#include <QElapsedTimer>
+
+/// weight of an updater that doesn't know the size of its updates (e.g. metadata refreshes)
+static const double s_minimumUpdaterWeight = 1024 * 1024;
+/// how much every new throughput sample counts towards the smoothed value
+static const qreal s_throughputSmoothing = 0.3;
 
 class UpdateTransaction : public Transaction
 {
     Q_OBJECT
+    Q_PROPERTY(quint64 throughput READ throughput NOTIFY throughputChanged)
 public:
     UpdateTransaction(ResourcesUpdatesModel * /*parent*/, const QVector<AbstractBackendUpdater *> &updaters)
         : Transaction(nullptr, nullptr, Transaction::InstallRole)
@@ -28,6 +35,10 @@ public:
     {
         bool cancelable = false;
         foreach (auto updater, m_allUpdaters) {
+            const double weight = qMax(updater->updateSize(), s_minimumUpdaterWeight);
+            m_weights.insert(updater, weight);
+            m_totalWeight += weight;
+
             connect(updater, &AbstractBackendUpdater::progressingChanged, this, &UpdateTransaction::slotProgressingChanged);
             connect(updater, &AbstractBackendUpdater::downloadSpeedChanged, this, &UpdateTransaction::slotDownloadSpeedChanged);
             connect(updater, &AbstractBackendUpdater::progressChanged, this, &UpdateTransaction::slotUpdateProgress);
@@ -82,11 +93,19 @@ public:
 
     void slotUpdateProgress()
     {
-        qreal total = 0;
-        foreach (AbstractBackendUpdater *updater, m_allUpdaters) {
-            total += updater->progress();
+        // Progress is weighted by the size of what each updater has to do
+        double processed = 0;
+        for (AbstractBackendUpdater *updater : m_allUpdaters) {
+            processed += m_weights.value(updater) * updater->progress() / 100.;
         }
-        setProgress(total / m_allUpdaters.count());
+        setProgress(100. * processed / m_totalWeight);
+        refreshRemainingTime(processed);
+    }
+
+    /// bytes processed per second, smoothed
+    quint64 throughput() const
+    {
+        return qRound64(m_throughput);
     }
 
     void slotDownloadSpeedChanged()
@@ -109,10 +128,40 @@ public:
 
 Q_SIGNALS:
     void finished();
+    void throughputChanged(quint64 throughput);
 
 private:
+    void refreshRemainingTime(double processed)
+    {
+        if (!m_sampleTimer.isValid()) {
+            m_sampleTimer.start();
+            m_lastProcessed = processed;
+            return;
+        }
+
+        // Sample at most once per second, otherwise the estimate jumps around
+        const qint64 elapsed = m_sampleTimer.elapsed();
+        if (elapsed < 1000)
+            return;
+
+        const qreal sample = qMax(0., processed - m_lastProcessed) * 1000. / elapsed;
+        m_throughput = m_throughput == 0 ? sample : s_throughputSmoothing * sample + (1 - s_throughputSmoothing) * m_throughput;
+        m_lastProcessed = processed;
+        m_sampleTimer.restart();
+        Q_EMIT throughputChanged(throughput());
+
+        if (m_throughput > 0)
+            setRemainingTime(qRound((m_totalWeight - processed) / m_throughput));
+    }
+
     QVector<AbstractBackendUpdater *> m_updatersWaitingForFeedback;
     const QVector<AbstractBackendUpdater *> m_allUpdaters;
+    QHash<AbstractBackendUpdater *, double> m_weights;
+    double m_totalWeight = 0;
+
+    QElapsedTimer m_sampleTimer;
+    double m_lastProcessed = 0;
+    qreal m_throughput = 0;
 };
 
 ResourcesUpdatesModel::ResourcesUpdatesModel(QObject *parent)
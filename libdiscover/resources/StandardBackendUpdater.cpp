@@ -15,6 +15,9 @@
 #include <resources/AbstractResourcesBackend.h>
 #include <resources/StandardBackendUpdater.h>
 
+/// weight of a resource that doesn't know its size
+static const double s_minimumWeight = 64 * 1024;
+
 StandardBackendUpdater::StandardBackendUpdater(AbstractResourcesBackend *parent)
     : AbstractBackendUpdater(parent)
     , m_backend(parent)
@@ -36,10 +39,17 @@ StandardBackendUpdater::StandardBackendUpdater(AbstractResourcesBackend *parent)
     connect(&m_timer, &QTimer::timeout, this, &StandardBackendUpdater::refreshUpdateable);
 }
 
-void StandardBackendUpdater::resourcesChanged(AbstractResource *res, const QVector<QByteArray> &props)
+void StandardBackendUpdater::resourcesChanged(const QVector<AbstractResource *> &resources, const QVector<QByteArray> &props)
 {
-    if (props.contains("state") && (res->state() == AbstractResource::Upgradeable || m_upgradeable.contains(res)))
-        m_timer.start();
+    if (!props.contains("state"))
+        return;
+
+    for (AbstractResource *res : resources) {
+        if (res->state() == AbstractResource::Upgradeable || m_upgradeable.contains(res)) {
+            m_timer.start();
+            return;
+        }
+    }
 }
 
 bool StandardBackendUpdater::hasUpdates() const
@@ -57,6 +67,16 @@ void StandardBackendUpdater::start()
         return a->name() < b->name();
     });
 
+    // Weigh each resource by its size, so that big updates count for what they are
+    // when reporting progress. Resources that don't know their size still count a bit.
+    m_weights.clear();
+    m_totalWeight = 0;
+    for (AbstractResource *res : qAsConst(upgradeList)) {
+        const double weight = qMax<double>(res->size(), s_minimumWeight);
+        m_weights.insert(res, weight);
+        m_totalWeight += weight;
+    }
+
     const bool couldCancel = m_canCancel;
     foreach (AbstractResource *res, upgradeList) {
         m_pendingResources += res;
@@ -146,12 +166,20 @@ void StandardBackendUpdater::refreshProgress()
         return;
     }
 
-    int allProgresses = (m_toUpgrade.size() - m_pendingResources.size()) * 100;
+    if (m_totalWeight <= 0) {
+        return;
+    }
+
+    double done = m_totalWeight;
+    for (AbstractResource *res : qAsConst(m_pendingResources)) {
+        done -= m_weights.value(res);
+    }
     const auto allTransactions = transactions();
     for (auto t : allTransactions) {
-        allProgresses += t->progress();
+        if (m_pendingResources.contains(t->resource()))
+            done += m_weights.value(t->resource()) * t->progress() / 100.;
     }
-    setProgress(allProgresses / m_toUpgrade.size());
+    setProgress(100. * done / m_totalWeight);
 }
 
 void StandardBackendUpdater::refreshUpdateable()
@@ -226,6 +254,8 @@ void StandardBackendUpdater::cleanup()
 {
     m_lastUpdate = QDateTime::currentDateTime();
     m_toUpgrade.clear();
+    m_weights.clear();
+    m_totalWeight = 0;
 
     refreshUpdateable();
     emit progressingChanged(false);
@@ -10,6 +10,7 @@
 #include "AbstractResourcesBackend.h"
 #include "discovercommon_export.h"
 #include <QDateTime>
+#include <QHash>
 #include <QSet>
 #include <QTimer>
 #include <resources/AbstractBackendUpdater.h>
@@ -48,10 +49,11 @@ Q_SIGNALS:
 public Q_SLOTS:
     void transactionRemoved(Transaction *t);
     void cleanup();
+    /// Looks again for the upgradeable resources, done already every time the backend stops fetching
+    void refreshUpdateable();
 
 private:
-    void resourcesChanged(AbstractResource *res, const QVector<QByteArray> &props);
-    void refreshUpdateable();
+    void resourcesChanged(const QVector<AbstractResource *> &resources, const QVector<QByteArray> &props);
     void transactionAdded(Transaction *newTransaction);
     void transactionProgressChanged();
     void refreshProgress();
@@ -61,6 +63,9 @@ private:
     QSet<AbstractResource *> m_upgradeable;
     AbstractResourcesBackend *const m_backend;
     QSet<AbstractResource *> m_pendingResources;
+    /// size of each resource being updated, used to weigh its progress
+    QHash<AbstractResource *, double> m_weights;
+    double m_totalWeight = 0;
     bool m_settingUp;
     qreal m_progress;
     QDateTime m_lastUpdate;
@@ -0,0 +1,34 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "StringInterner.h"
+#include <QMutex>
+#include <QSet>
+
+struct InternedStrings {
+    QMutex mutex;
+    QSet<QString> strings;
+};
+Q_GLOBAL_STATIC(InternedStrings, s_strings)
+
+QString StringInterner::intern(const QString &value)
+{
+    if (value.isEmpty())
+        return {};
+
+    QMutexLocker locker(&s_strings->mutex);
+    auto it = s_strings->strings.constFind(value);
+    if (it == s_strings->strings.constEnd())
+        it = s_strings->strings.insert(value);
+    return *it;
+}
+
+size_t StringInterner::footprint(const QString &value)
+{
+    if (value.isEmpty() || !value.isDetached())
+        return 0;
+    return sizeof(QStringData) + (value.capacity() + 1) * sizeof(QChar);
+}
@@ -0,0 +1,32 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#ifndef STRINGINTERNER_H
+#define STRINGINTERNER_H
+
+#include "discovercommon_export.h"
+#include <QString>
+
+/**
+ * \class StringInterner  StringInterner.h "StringInterner.h"
+ *
+ * \brief Shares the storage of strings that repeat across many resources.
+ *
+ * Values such as origins, branches, architectures or runtimes are the same for
+ * thousands of resources. Resources keep the string returned by intern() so that
+ * all of them reference the same buffer instead of a copy each.
+ */
+class DISCOVERCOMMON_EXPORT StringInterner
+{
+public:
+    /// @returns a string equal to @p value, sharing its data with every other interned copy
+    static QString intern(const QString &value);
+
+    /// @returns the heap memory used by @p value, 0 when it's shared with other strings
+    static size_t footprint(const QString &value);
+};
+
+#endif // STRINGINTERNER_H
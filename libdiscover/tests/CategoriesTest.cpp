@@ -6,8 +6,132 @@
 
 #include <Category/CategoriesReader.h>
 #include <Category/Category.h>
+#include <QDir>
+#include <QJsonArray>
 #include <QList>
+#include <QStandardPaths>
+#include <QTemporaryFile>
 #include <QtTest>
+#include <resources/AbstractResource.h>
+#include <resources/PackageState.h>
+
+class MatcherResource : public AbstractResource
+{
+public:
+    MatcherResource(const QString &packageName, const QString &appstreamId, const QString &section, const QStringList &categories)
+        : AbstractResource(nullptr)
+        , m_packageName(packageName)
+        , m_appstreamId(appstreamId)
+        , m_section(section)
+        , m_categories(categories)
+    {
+    }
+
+    QString packageName() const override
+    {
+        return m_packageName;
+    }
+    QString appstreamId() const override
+    {
+        return m_appstreamId;
+    }
+    QString section() override
+    {
+        return m_section;
+    }
+    QStringList categories() override
+    {
+        return m_categories;
+    }
+
+    QString name() const override
+    {
+        return m_packageName;
+    }
+    QString comment() override
+    {
+        return {};
+    }
+    QVariant icon() const override
+    {
+        return {};
+    }
+    bool canExecute() const override
+    {
+        return false;
+    }
+    void invokeApplication() const override
+    {
+    }
+    State state() override
+    {
+        return None;
+    }
+    Type type() const override
+    {
+        return Application;
+    }
+    int size() override
+    {
+        return 0;
+    }
+    QJsonArray licenses() override
+    {
+        return {};
+    }
+    QString installedVersion() const override
+    {
+        return {};
+    }
+    QString availableVersion() const override
+    {
+        return {};
+    }
+    QString longDescription() override
+    {
+        return {};
+    }
+    QString origin() const override
+    {
+        return {};
+    }
+    QString author() const override
+    {
+        return {};
+    }
+    QList<PackageState> addonsInformation() override
+    {
+        return {};
+    }
+    QString sourceIcon() const override
+    {
+        return {};
+    }
+    QDate releaseDate() const override
+    {
+        return {};
+    }
+    void fetchChangelog() override
+    {
+    }
+
+private:
+    const QString m_packageName;
+    const QString m_appstreamId;
+    const QString m_section;
+    const QStringList m_categories;
+};
+
+static QString dumpCategories(const QVector<Category *> &cats, int depth = 0)
+{
+    QString ret;
+    for (Category *cat : cats) {
+        QDebug(&ret) << QString(depth, QLatin1Char(' ')) << cat->name() << cat->icon() << cat->decoration() << cat->isAddons() << cat->andFilters()
+                     << cat->orFilters() << cat->notFilters() << '\n';
+        ret += dumpCategories(cat->subCategories(), depth + 1);
+    }
+    return ret;
+}
 
 class CategoriesTest : public QObject
 {
@@ -15,6 +139,7 @@ class CategoriesTest : public QObject
 public:
     CategoriesTest()
     {
+        QStandardPaths::setTestModeEnabled(true);
     }
 
     QVector<Category *> populateCategories()
@@ -52,6 +177,121 @@ private Q_SLOTS:
         auto categories = populateCategories();
         QVERIFY(!categories.isEmpty());
     }
+
+    void testCategoriesCache()
+    {
+        const QStringList categoryFiles = {
+            QFINDTESTDATA("../backends/PackageKitBackend/packagekit-backend-categories.xml"),
+            QFINDTESTDATA("../backends/FlatpakBackend/flatpak-backend-categories.xml"),
+            QFINDTESTDATA("../backends/DummyBackend/dummy-backend-categories.xml"),
+        };
+        QDir cacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/categories"));
+        cacheDir.removeRecursively();
+
+        CategoriesReader reader;
+        const auto parsed = reader.loadCategoriesPaths(categoryFiles);
+        QVERIFY(!parsed.isEmpty());
+        QCOMPARE(cacheDir.entryList(QDir::Files).count(), 1);
+
+        const auto cached = reader.loadCategoriesPaths(categoryFiles);
+        QCOMPARE(dumpCategories(cached), dumpCategories(parsed));
+    }
+
+    void testCategoryMatches_data()
+    {
+        QTest::addColumn<QString>("packageName");
+        QTest::addColumn<QString>("appstreamId");
+        QTest::addColumn<QString>("section");
+        QTest::addColumn<QStringList>("categories");
+        QTest::addColumn<QStringList>("expected");
+
+        QTest::newRow("nothing") << "foo" << "org.example.foo" << "misc" << QStringList{} << QStringList{};
+        QTest::newRow("or category") << "foo" << "org.example.foo" << "misc" << QStringList{QStringLiteral("Game")} << QStringList{QStringLiteral("Games")};
+        QTest::newRow("or section") << "foo" << "org.example.foo" << "games" << QStringList{} << QStringList{QStringLiteral("Games")};
+        QTest::newRow("or wildcard") << "foo-game" << "org.example.foo" << "misc" << QStringList{} << QStringList{QStringLiteral("Games")};
+        QTest::newRow("and") << "foo" << "org.example.foo" << "misc" << QStringList{QStringLiteral("Game"), QStringLiteral("Education")}
+                             << QStringList{QStringLiteral("Games"), QStringLiteral("Educational games")};
+        QTest::newRow("not category") << "foo" << "org.example.foo" << "misc"
+                                      << QStringList{QStringLiteral("Game"), QStringLiteral("Education"), QStringLiteral("Adult")}
+                                      << QStringList{QStringLiteral("Educational games")};
+        QTest::newRow("not name") << "blocked" << "org.example.foo" << "misc" << QStringList{QStringLiteral("Game")} << QStringList{};
+        QTest::newRow("appstream wildcard") << "foo" << "org.kde.foo" << "misc" << QStringList{} << QStringList{QStringLiteral("KDE")};
+        QTest::newRow("category is not a substring") << "foo" << "org.example.foo" << "misc" << QStringList{QStringLiteral("Games")} << QStringList{};
+    }
+
+    void testCategoryMatches()
+    {
+        QFETCH(QString, packageName);
+        QFETCH(QString, appstreamId);
+        QFETCH(QString, section);
+        QFETCH(QStringList, categories);
+        QFETCH(QStringList, expected);
+
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        file.write(R"(<?xml version="1.0" encoding="UTF-8"?>
+<Menu>
+  <Menu>
+    <Name>Games</Name>
+    <Include>
+      <Or>
+        <PkgWildcard>*game*</PkgWildcard>
+        <Category>Game</Category>
+        <PkgSection>games</PkgSection>
+      </Or>
+      <Not>
+        <Category>Adult</Category>
+        <PkgName>blocked</PkgName>
+      </Not>
+    </Include>
+  </Menu>
+  <Menu>
+    <Name>Educational games</Name>
+    <Include>
+      <And>
+        <Category>Game</Category>
+        <Category>Education</Category>
+      </And>
+    </Include>
+  </Menu>
+  <Menu>
+    <Name>KDE</Name>
+    <Include>
+      <Or>
+        <AppstreamIdWildcard>org.kde.*</AppstreamIdWildcard>
+      </Or>
+    </Include>
+  </Menu>
+</Menu>
+)");
+        file.close();
+
+        CategoriesReader reader;
+        const auto cats = reader.loadCategoriesPath(file.fileName());
+        QCOMPARE(cats.count(), 3);
+
+        MatcherResource res(packageName, appstreamId, section, categories);
+        QStringList matched;
+        for (Category *cat : cats) {
+            if (res.categoryMatches(cat))
+                matched += cat->name();
+        }
+        matched.sort();
+        expected.sort();
+        QCOMPARE(matched, expected);
+        qDeleteAll(cats);
+    }
+
+    void testCategoryMatcherReset()
+    {
+        Category cat(QStringLiteral("Games"), {}, {{CategoryFilter, QStringLiteral("Game")}}, {}, {}, {}, false);
+        MatcherResource res(QStringLiteral("foo"), QStringLiteral("org.example.foo"), QStringLiteral("misc"), {QStringLiteral("Game")});
+        QVERIFY(res.categoryMatches(&cat));
+
+        // Changing the filters must not keep using what was compiled before
+        cat.setAndFilter({{PkgSectionFilter, QStringLiteral("games")}});
+        QVERIFY(!res.categoryMatches(&cat));
+    }
 };
 
 QTEST_MAIN(CategoriesTest)
@@ -0,0 +1,201 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Aleix Pol Gonzalez <aleixpol@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QPixmap>
+#include <QStandardPaths>
+#include <QtTest>
+#include <cstring>
+#include <resources/IconLoader.h>
+
+// Stays open until the test decides how it ends
+class PendingReply : public QNetworkReply
+{
+public:
+    PendingReply(const QNetworkRequest &request, QObject *parent)
+        : QNetworkReply(parent)
+    {
+        setRequest(request);
+        setUrl(request.url());
+        setOperation(QNetworkAccessManager::GetOperation);
+        open(QIODevice::ReadOnly);
+    }
+
+    void finish(const QByteArray &data)
+    {
+        m_data = data;
+        setFinished(true);
+        Q_EMIT finished();
+    }
+
+    void fail()
+    {
+        setError(QNetworkReply::ContentNotFoundError, QStringLiteral("not found"));
+        setFinished(true);
+        Q_EMIT finished();
+    }
+
+    void abort() override
+    {
+    }
+    bool isSequential() const override
+    {
+        return true;
+    }
+    qint64 bytesAvailable() const override
+    {
+        return m_data.size() - m_read + QIODevice::bytesAvailable();
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const qint64 size = qMin(maxSize, qint64(m_data.size() - m_read));
+        memcpy(data, m_data.constData() + m_read, size);
+        m_read += size;
+        return size;
+    }
+
+private:
+    QByteArray m_data;
+    qint64 m_read = 0;
+};
+
+class PendingNetworkAccessManager : public QNetworkAccessManager
+{
+public:
+    QVector<PendingReply *> replies;
+
+    PendingReply *takeReply(const QUrl &url)
+    {
+        for (int i = 0; i < replies.count(); ++i) {
+            if (replies[i]->url() == url)
+                return replies.takeAt(i);
+        }
+        return nullptr;
+    }
+
+protected:
+    QNetworkReply *createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData) override
+    {
+        Q_UNUSED(op)
+        Q_UNUSED(outgoingData)
+        auto reply = new PendingReply(request, this);
+        replies += reply;
+        return reply;
+    }
+};
+
+class IconLoaderTest : public QObject
+{
+    Q_OBJECT
+public:
+    IconLoaderTest()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+    }
+
+private Q_SLOTS:
+    void init()
+    {
+        QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/icons")).removeRecursively();
+    }
+
+    void testDownloadQueue()
+    {
+        auto nam = new PendingNetworkAccessManager;
+        IconLoader loader(nam);
+
+        QVector<QUrl> urls;
+        for (int i = 0; i < 10; ++i) {
+            urls += QUrl(QStringLiteral("https://icons.example.org/%1.png").arg(i));
+            QVERIFY(loader.fetchRemote(urls.constLast(), nullptr).isEmpty());
+        }
+
+        // A few at a time, and asking again doesn't download it twice
+        QVERIFY(loader.fetchRemote(urls[0], nullptr).isEmpty());
+        QCOMPARE(nam->replies.count(), 6);
+        for (int i = 0; i < 6; ++i) {
+            QCOMPARE(nam->replies[i]->url(), urls[i]);
+        }
+
+        // Whatever was asked for last goes next
+        nam->takeReply(urls[0])->finish("icon");
+        QCOMPARE(nam->replies.count(), 6);
+        QCOMPARE(nam->replies.constLast()->url(), urls[9]);
+
+        nam->takeReply(urls[1])->finish("icon");
+        QCOMPARE(nam->replies.constLast()->url(), urls[8]);
+
+        const QString path = loader.fetchRemote(urls[0], nullptr);
+        QCOMPARE(path, IconLoader::cachePath(urls[0]));
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.readAll(), QByteArray("icon"));
+    }
+
+    void testFailedDownload()
+    {
+        auto nam = new PendingNetworkAccessManager;
+        IconLoader loader(nam);
+
+        const QUrl url(QStringLiteral("https://icons.example.org/missing.png"));
+        QVERIFY(loader.fetchRemote(url, nullptr).isEmpty());
+        QCOMPARE(nam->replies.count(), 1);
+        nam->takeReply(url)->fail();
+
+        // Not asked for again during this session
+        QVERIFY(loader.fetchRemote(url, nullptr).isEmpty());
+        QCOMPARE(nam->replies.count(), 0);
+        QVERIFY(!QFile::exists(IconLoader::cachePath(url)));
+    }
+
+    void testIconCache()
+    {
+        auto nam = new PendingNetworkAccessManager;
+        IconLoader loader(nam);
+
+        int builds = 0;
+        const auto build = [&builds] {
+            ++builds;
+            QPixmap pixmap(16, 16);
+            pixmap.fill(Qt::red);
+            return QIcon(pixmap);
+        };
+        loader.icon(QStringLiteral("built"), build);
+        loader.icon(QStringLiteral("built"), build);
+        QCOMPARE(builds, 1);
+
+        // Nothing to show yet, built again next time
+        int nullBuilds = 0;
+        const auto buildNull = [&nullBuilds] {
+            ++nullBuilds;
+            return QIcon();
+        };
+        QVERIFY(loader.icon(QStringLiteral("null"), buildNull).isNull());
+        QVERIFY(loader.icon(QStringLiteral("null"), buildNull).isNull());
+        QCOMPARE(nullBuilds, 2);
+
+        // Still waiting for a download, built again next time
+        int pendingBuilds = 0;
+        const QUrl url(QStringLiteral("https://icons.example.org/pending.png"));
+        const auto buildPending = [&] {
+            ++pendingBuilds;
+            loader.fetchRemote(url, nullptr);
+            return build();
+        };
+        loader.icon(QStringLiteral("pending"), buildPending);
+        loader.icon(QStringLiteral("pending"), buildPending);
+        QCOMPARE(pendingBuilds, 2);
+    }
+};
+
+QTEST_MAIN(IconLoaderTest)
+
+#include "IconLoaderTest.moc"
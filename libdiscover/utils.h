@@ -9,8 +9,10 @@
 
 #include <QElapsedTimer>
 #include <QJsonValue>
+#include <QPair>
 #include <QScopeGuard>
 #include <QString>
+#include <QVector>
 #include <functional>
 
 class OneTimeAction : public QObject
@@ -122,6 +124,22 @@ static QSet<T> kToSet(const QList<T> &set)
     return QSet<T>(set.begin(), set.end());
 }
 
+/**
+ * Splits the sorted @p rows into ranges of consecutive rows, as pairs of first and last row.
+ * Useful to notify a model's changes with as few signals as possible.
+ */
+inline QVector<QPair<int, int>> kRowRanges(const QVector<int> &rows)
+{
+    QVector<QPair<int, int>> ret;
+    for (int row : rows) {
+        if (!ret.isEmpty() && ret.last().second == row - 1)
+            ret.last().second = row;
+        else
+            ret.append({row, row});
+    }
+    return ret;
+}
+
 class ElapsedDebug : private QElapsedTimer
 {
 public:
@@ -20,6 +20,7 @@ DiscoverUpdate::DiscoverUpdate()
     connect(ResourcesModel::global(), &ResourcesModel::fetchingChanged, this, &DiscoverUpdate::start);
     connect(m_resourcesUpdatesModel, &ResourcesUpdatesModel::progressingChanged, this, &DiscoverUpdate::start);
     connect(ResourcesModel::global(), &ResourcesModel::backendsChanged, this, &DiscoverUpdate::start);
+    m_startTimer.start();
 }
 
 DiscoverUpdate::~DiscoverUpdate() = default;
@@ -30,7 +31,7 @@ void DiscoverUpdate::start()
         return;
 
     m_resourcesUpdatesModel->setOfflineUpdates(m_offlineUpdates);
-    qDebug() << "ready" << ResourcesModel::global()->updatesCount();
+    qDebug() << "ready" << ResourcesModel::global()->updatesCount() << "after" << m_startTimer.elapsed() << "ms";
     m_resourcesUpdatesModel->prepare();
     qDebug() << "steady" << m_resourcesUpdatesModel->rowCount({});
     m_resourcesUpdatesModel->updateAll();
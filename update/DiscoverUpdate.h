@@ -7,6 +7,7 @@
 #ifndef DISCOVERUPDATE_H
 #define DISCOVERUPDATE_H
 
+#include <QElapsedTimer>
 #include <QObject>
 #include <QSet>
 #include <QUrl>
@@ -35,6 +36,7 @@ private:
     ResourcesUpdatesModel *const m_resourcesUpdatesModel;
     bool m_done = false;
     bool m_offlineUpdates = false;
+    QElapsedTimer m_startTimer;
 };
 
 #endif // DISCOVERUPDATE_H
@@ -31,6 +31,8 @@ int main(int argc, char **argv)
         parser.process(app);
         about.processCommandLine(&parser);
         DiscoverBackendsFactory::processCommandLine(&parser, false);
+        // We are only here to apply updates, the backends don't need to load anything for browsing
+        DiscoverBackendsFactory::setUpdatesOnly(true);
 
         exp.setOfflineUpdates(parser.isSet(offlineUpdate));
     }